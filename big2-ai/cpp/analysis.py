@@ -14,10 +14,33 @@ from pathlib import Path
 import sys
 
 
+def read_features(path):
+    """Read a feature table written by GameCoordinator.
+
+    Parquet files are decoded with pandas. Arrow IPC / Feather files
+    (.arrow, .feather) and shared-memory segments ("/name" with no
+    extension, as written with OutputFormat::kSharedMemory) are memory-mapped
+    and read without decoding.
+    """
+    path = str(path)
+    if path.endswith(".parquet"):
+        return pd.read_parquet(path)
+
+    import pyarrow as pa
+
+    if path.startswith("/") and "." not in Path(path).name and path.count("/") == 1:
+        # shm_open name -> file under /dev/shm
+        path = "/dev/shm" + path
+    if not Path(path).exists():
+        raise FileNotFoundError(path)
+    with pa.memory_map(path) as source:
+        return pa.ipc.open_file(source).read_all().to_pandas()
+
+
 def load_data(game_file="game_features.parquet", turn_file="turn_features.parquet"):
-    """Load the parquet files and return DataFrames."""
+    """Load the feature files and return DataFrames."""
     try:
-        game_df = pd.read_parquet(game_file)
+        game_df = read_features(game_file)
         print(f"✓ Loaded game features: {game_file}")
         print(f"  Shape: {game_df.shape}")
     except FileNotFoundError:
@@ -25,7 +48,7 @@ def load_data(game_file="game_features.parquet", turn_file="turn_features.parque
         game_df = None
 
     try:
-        turn_df = pd.read_parquet(turn_file)
+        turn_df = read_features(turn_file)
         print(f"✓ Loaded turn features: {turn_file}")
         print(f"  Shape: {turn_df.shape}")
     except FileNotFoundError:
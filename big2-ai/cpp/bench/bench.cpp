@@ -0,0 +1,123 @@
+// bench.cpp
+#include "bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Every operator new of the bench binary goes through here and is counted
+static std::atomic<uint64_t> g_allocations{0};
+
+static void *counted_alloc(size_t size, size_t alignment = 0) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (size == 0) {
+    size = 1;
+  }
+  void *p = alignment ? std::aligned_alloc(alignment, (size + alignment - 1) /
+                                                          alignment * alignment)
+                      : std::malloc(size);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void *operator new(size_t size) { return counted_alloc(size); }
+void *operator new[](size_t size) { return counted_alloc(size); }
+void *operator new(size_t size, std::align_val_t alignment) {
+  return counted_alloc(size, static_cast<size_t>(alignment));
+}
+void *operator new[](size_t size, std::align_val_t alignment) {
+  return counted_alloc(size, static_cast<size_t>(alignment));
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return counted_alloc(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return counted_alloc(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+void operator delete[](void *p, size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+  std::free(p);
+}
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  std::free(p);
+}
+
+std::vector<Bench::Entry> &Bench::registry() {
+  static std::vector<Entry> entries;
+  return entries;
+}
+
+void Bench::add(const std::string &name, Body body, double items,
+                const std::string &unit) {
+  registry().push_back({name, std::move(body), items, unit});
+}
+
+uint64_t Bench::allocations() {
+  return g_allocations.load(std::memory_order_relaxed);
+}
+
+void Bench::run(const std::string &filter, double min_seconds,
+                int repetitions) {
+  using Clock = std::chrono::steady_clock;
+  std::printf("%-36s %12s %12s %12s\n", "benchmark", "ns/item", "allocs/item",
+              "items");
+  for (const Entry &entry : registry()) {
+    if (entry.name.find(filter) == std::string::npos) {
+      continue;
+    }
+    // Grow the iteration count until one run is long enough to time
+    uint64_t iterations = 1;
+    double seconds = 0.0;
+    while (true) {
+      const auto start = Clock::now();
+      entry.body(iterations);
+      seconds = std::chrono::duration<double>(Clock::now() - start).count();
+      if (seconds >= min_seconds) {
+        break;
+      }
+      const double scale = seconds > 0 ? 1.5 * min_seconds / seconds : 100;
+      iterations = static_cast<uint64_t>(
+          iterations * std::clamp(scale, 2.0, 100.0));
+    }
+
+    double best = seconds;
+    uint64_t allocations = 0;
+    for (int r = 0; r < repetitions; ++r) {
+      const uint64_t allocs_before = Bench::allocations();
+      const auto start = Clock::now();
+      entry.body(iterations);
+      best = std::min(
+          best, std::chrono::duration<double>(Clock::now() - start).count());
+      allocations = Bench::allocations() - allocs_before;
+    }
+
+    const double items = iterations * entry.items;
+    std::printf("%-36s %12.2f %12.3f %12.0f %s\n", entry.name.c_str(),
+                best * 1e9 / items, allocations / items, items,
+                entry.unit.c_str());
+  }
+}
@@ -0,0 +1,62 @@
+// bench.h
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Minimal microbenchmark harness for the engine (make bench).
+ *
+ * A benchmark body runs a given number of iterations. The harness doubles
+ * the count until one run lasts at least the minimum time, repeats that run
+ * and reports the fastest in ns per item, together with the heap
+ * allocations (operator new calls, counted by the bench binary's
+ * replacement) per item. No external library is needed.
+ */
+class Bench {
+public:
+  using Body = std::function<void(uint64_t iterations)>;
+
+  /**
+   * @param name   Name shown in the report and matched by the filter.
+   * @param body   Runs `iterations` iterations.
+   * @param items  Items processed per iteration (e.g. rows of a corpus).
+   * @param unit   Name of an item ("op", "row", ...).
+   */
+  static void add(const std::string &name, Body body, double items = 1.0,
+                  const std::string &unit = "op");
+
+  /**
+   * @brief Heap allocations made so far by all threads.
+   */
+  static uint64_t allocations();
+
+  /**
+   * @brief Run every benchmark whose name contains `filter`; prints one
+   * line each.
+   */
+  static void run(const std::string &filter, double min_seconds,
+                  int repetitions);
+
+  /**
+   * @brief Keep `value` alive so the computation producing it is not
+   * optimized away.
+   */
+  template <typename T> static void do_not_optimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+private:
+  struct Entry {
+    std::string name;
+    Body body;
+    double items;
+    std::string unit;
+  };
+  static std::vector<Entry> &registry();
+};
+
+#endif // BENCH_H
@@ -0,0 +1,41 @@
+// bench_corpus.cpp
+#include "bench_corpus.h"
+
+#include <random>
+
+#include "feature_extractor.h"
+
+BenchCorpus::BenchCorpus(int num_games, unsigned seed) {
+  std::mt19937 rng(seed);
+  for (int g = 0; g < num_games; ++g) {
+    Game game;
+    game.shuffle_deal(rng);
+    std::array<GreedyPlayer, 2> players;
+    for (int seat = 0; seat < 2; ++seat) {
+      players[seat].accept_deal(game.player_hand(seat), seat);
+    }
+    GameRecord record;
+    record.set_game_id(g);
+    record.set_initial_state(game);
+
+    // Same order of calls as GameSimulator
+    while (!game.is_over()) {
+      const int current = game.current_player();
+      Position position{game, players[current], Move::Combination::kPass};
+      position.move = players[current].select_move();
+      const Move move = position.move;
+      _positions.push_back(position);
+      game.apply_move(move);
+      record.add_move(move);
+      players[1 - current].accept_opponent_move(move);
+    }
+    _num_turn_rows += record.turns().size() * FeatureExtractor::kPerspectives;
+    _records.push_back(std::move(record));
+  }
+
+  for (const Position &position : _positions) {
+    const bool lead =
+        position.game.last_move().combination == Move::Combination::kPass;
+    (lead ? _leads : _responses).push_back(position);
+  }
+}
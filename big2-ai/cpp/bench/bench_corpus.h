@@ -0,0 +1,67 @@
+// bench_corpus.h
+#ifndef BENCH_CORPUS_H
+#define BENCH_CORPUS_H
+
+#include <vector>
+
+#include "game.h"
+#include "game_record.h"
+#include "greedy_player.h"
+
+/**
+ * @brief Fixed positions for the benchmarks, from seeded greedy games.
+ *
+ * Every state reached in the games is kept with the mover's player and the
+ * move played, split into lead positions (the mover starts a trick) and
+ * response positions (the mover must beat the last move). The same seed
+ * always gives the same corpus, so runs before and after a change measure
+ * the same work.
+ */
+class BenchCorpus {
+public:
+  static constexpr unsigned kDefaultSeed = 2024;
+
+  /**
+   * @brief One position: the state before a move and who is to move.
+   */
+  struct Position {
+    Game game;
+    GreedyPlayer mover; // in the state it had when choosing `move`
+    Move move;
+  };
+
+  explicit BenchCorpus(int num_games = 256, unsigned seed = kDefaultSeed);
+
+  const std::vector<Position> &positions() const { return _positions; }
+  const std::vector<Position> &leads() const { return _leads; }
+  const std::vector<Position> &responses() const { return _responses; }
+
+  /**
+   * @brief The games as fully recorded GameRecords (RecordFields::kAll).
+   */
+  const std::vector<GameRecord> &records() const { return _records; }
+
+  /**
+   * @brief Turn-level rows of records() (one per turn and perspective).
+   */
+  size_t num_turn_rows() const { return _num_turn_rows; }
+
+private:
+  std::vector<Position> _positions;
+  std::vector<Position> _leads;
+  std::vector<Position> _responses;
+  std::vector<GameRecord> _records;
+  size_t _num_turn_rows = 0;
+};
+
+/**
+ * @brief Register the engine benchmarks (engine_bench.cpp).
+ */
+void add_engine_benchmarks(const BenchCorpus &corpus);
+
+/**
+ * @brief Register one benchmark per feature extractor (feature_bench.cpp).
+ */
+void add_feature_benchmarks(const BenchCorpus &corpus);
+
+#endif // BENCH_CORPUS_H
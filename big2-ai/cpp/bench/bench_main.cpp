@@ -0,0 +1,58 @@
+// bench_main.cpp
+//
+// Microbenchmarks of the engine primitives and feature extractors over a
+// fixed, seeded corpus of positions.
+//
+//   big2-bench [-f filter] [-t min_seconds] [-r repetitions] [-g games]
+//
+// Prints ns and heap allocations per item for every benchmark whose name
+// contains the filter.
+#include "bench.h"
+#include "bench_corpus.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+static void usage() {
+  std::cerr << "usage: big2-bench [-f filter] [-t min_seconds] "
+               "[-r repetitions] [-g corpus_games]\n";
+}
+
+int main(int argc, char **argv) {
+  std::string filter;
+  double min_seconds = 0.2;
+  int repetitions = 3;
+  int games = 256;
+  for (int i = 1; i < argc; ++i) {
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    if (std::strcmp(argv[i], "-f") == 0) {
+      filter = argv[++i];
+    } else if (std::strcmp(argv[i], "-t") == 0) {
+      min_seconds = std::atof(argv[++i]);
+    } else if (std::strcmp(argv[i], "-r") == 0) {
+      repetitions = std::max(1, std::atoi(argv[++i]));
+    } else if (std::strcmp(argv[i], "-g") == 0) {
+      games = std::max(1, std::atoi(argv[++i]));
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  const BenchCorpus corpus(games);
+  std::cout << "Corpus: " << corpus.records().size() << " games (seed "
+            << BenchCorpus::kDefaultSeed << "), " << corpus.leads().size()
+            << " lead and " << corpus.responses().size()
+            << " response positions\n";
+
+  add_engine_benchmarks(corpus);
+  add_feature_benchmarks(corpus);
+  std::cout.flush();
+  Bench::run(filter, min_seconds, repetitions);
+  return 0;
+}
@@ -0,0 +1,132 @@
+// engine_bench.cpp
+#include "bench.h"
+#include "bench_corpus.h"
+
+#include <random>
+
+#include "partial_game.h"
+#include "util.h"
+
+// Cycles through a corpus without a division per iteration
+template <typename T> class Cycle {
+public:
+  explicit Cycle(const std::vector<T> &items) : _items(items) {}
+  const T &next() {
+    const T &item = _items[_index];
+    if (++_index == _items.size()) {
+      _index = 0;
+    }
+    return item;
+  }
+
+private:
+  const std::vector<T> &_items;
+  size_t _index = 0;
+};
+
+static std::vector<PartialGame>
+mover_views(const std::vector<BenchCorpus::Position> &positions) {
+  std::vector<PartialGame> views;
+  for (const auto &position : positions) {
+    views.emplace_back(position.game, position.game.current_player());
+  }
+  return views;
+}
+
+static void add_legal_moves(const std::string &name,
+                            const std::vector<BenchCorpus::Position> &corpus) {
+  Bench::add(name, [&corpus](uint64_t n) {
+    Cycle<BenchCorpus::Position> positions(corpus);
+    for (uint64_t i = 0; i < n; ++i) {
+      Bench::do_not_optimize(positions.next().game.get_legal_moves());
+    }
+  });
+}
+
+void add_engine_benchmarks(const BenchCorpus &corpus) {
+  static std::vector<int> move_ids;
+  static std::vector<Move> moves;
+  for (int id = 0; id < LEGAL_MOVES_SIZE; ++id) {
+    move_ids.push_back(id);
+    moves.emplace_back(id);
+  }
+
+  Bench::add("move_decode", [](uint64_t n) {
+    Cycle<int> ids(move_ids);
+    for (uint64_t i = 0; i < n; ++i) {
+      Bench::do_not_optimize(Move(ids.next()));
+    }
+  });
+
+  Bench::add("encode_move", [](uint64_t n) {
+    Cycle<Move> all(moves);
+    for (uint64_t i = 0; i < n; ++i) {
+      Bench::do_not_optimize(encodeMove(all.next()));
+    }
+  });
+
+  Bench::add("shuffle_deal", [](uint64_t n) {
+    std::mt19937 rng(BenchCorpus::kDefaultSeed);
+    Game game;
+    for (uint64_t i = 0; i < n; ++i) {
+      game.shuffle_deal(rng);
+      Bench::do_not_optimize(game);
+    }
+  });
+
+  // Applying a move changes the state, so each iteration works on a copy;
+  // game_copy is that copy alone
+  Bench::add("game_copy", [&corpus](uint64_t n) {
+    Cycle<BenchCorpus::Position> positions(corpus.positions());
+    for (uint64_t i = 0; i < n; ++i) {
+      Game game = positions.next().game;
+      Bench::do_not_optimize(game);
+    }
+  });
+
+  Bench::add("game_apply_move", [&corpus](uint64_t n) {
+    Cycle<BenchCorpus::Position> positions(corpus.positions());
+    for (uint64_t i = 0; i < n; ++i) {
+      const auto &position = positions.next();
+      Game game = position.game;
+      game.apply_move(position.move);
+      Bench::do_not_optimize(game);
+    }
+  });
+
+  add_legal_moves("game_legal_moves_lead", corpus.leads());
+  add_legal_moves("game_legal_moves_response", corpus.responses());
+
+  static const std::vector<PartialGame> views =
+      mover_views(corpus.positions());
+  Bench::add("partial_legal_moves", [](uint64_t n) {
+    Cycle<PartialGame> all(views);
+    for (uint64_t i = 0; i < n; ++i) {
+      Bench::do_not_optimize(all.next().get_legal_moves());
+    }
+  });
+
+  Bench::add("partial_possible_moves", [](uint64_t n) {
+    Cycle<PartialGame> all(views);
+    for (uint64_t i = 0; i < n; ++i) {
+      Bench::do_not_optimize(all.next().get_possible_moves());
+    }
+  });
+
+  // select_move() advances the player's own view, so it also runs on a copy
+  Bench::add("greedy_player_copy", [&corpus](uint64_t n) {
+    Cycle<BenchCorpus::Position> positions(corpus.positions());
+    for (uint64_t i = 0; i < n; ++i) {
+      GreedyPlayer player = positions.next().mover;
+      Bench::do_not_optimize(player);
+    }
+  });
+
+  Bench::add("greedy_select_move", [&corpus](uint64_t n) {
+    Cycle<BenchCorpus::Position> positions(corpus.positions());
+    for (uint64_t i = 0; i < n; ++i) {
+      GreedyPlayer player = positions.next().mover;
+      Bench::do_not_optimize(player.select_move());
+    }
+  });
+}
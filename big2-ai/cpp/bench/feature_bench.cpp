@@ -0,0 +1,61 @@
+// feature_bench.cpp
+#include "bench.h"
+#include "bench_corpus.h"
+
+#include <memory>
+
+#include "column_buffer.h"
+#include "feature_pipeline.h"
+#include "game_id_feature.h"
+#include "length_feature.h"
+#include "next_player_feature.h"
+#include "opponent_hand_size_feature.h"
+#include "outcome_feature.h"
+#include "perspective_feature.h"
+#include "player_hand_size_feature.h"
+#include "turn_game_id_feature.h"
+#include "turn_index_feature.h"
+#include "turn_outcome_feature.h"
+
+// Every feature class, including the key columns
+static std::vector<std::shared_ptr<FeatureExtractor>> all_features() {
+  return {
+      std::make_shared<GameIdFeature>(),
+      std::make_shared<OutcomeFeature>(),
+      std::make_shared<GameLengthExtractor>(),
+      std::make_shared<TurnGameIdFeature>(),
+      std::make_shared<TurnIndexFeature>(),
+      std::make_shared<PerspectiveFeature>(),
+      std::make_shared<TurnOutcomeFeature>(),
+      std::make_shared<NextPlayerFeature>(),
+      std::make_shared<PlayerHandSizeFeature>(),
+      std::make_shared<OpponentHandSizeFeature>(),
+  };
+}
+
+void add_feature_benchmarks(const BenchCorpus &corpus) {
+  for (auto &feature : all_features()) {
+    auto pipeline = std::make_shared<ExtractorListPipeline>(
+        feature->type(),
+        std::vector<std::shared_ptr<FeatureExtractor>>{feature});
+    const bool game_level =
+        feature->type() == FeatureExtractor::Type::GameLevel;
+    const size_t rows =
+        game_level ? corpus.records().size() : corpus.num_turn_rows();
+    auto buffer = std::make_shared<ColumnBuffer>(pipeline->columns()[0], rows);
+
+    // One iteration extracts the column for the whole corpus
+    Bench::add(
+        (game_level ? "game_feature_" : "turn_feature_") + feature->name(),
+        [&corpus, pipeline, buffer](uint64_t n) {
+          std::vector<ColumnSink> sinks{ColumnSink(*buffer)};
+          for (uint64_t i = 0; i < n; ++i) {
+            sinks[0] = ColumnSink(*buffer);
+            pipeline->extract(corpus.records().data(),
+                              corpus.records().size(), sinks);
+            Bench::do_not_optimize(sinks);
+          }
+        },
+        static_cast<double>(rows), "row");
+  }
+}
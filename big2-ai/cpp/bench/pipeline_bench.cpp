@@ -0,0 +1,374 @@
+// pipeline_bench.cpp
+//
+// End-to-end throughput of GameCoordinator on fixed configurations.
+//
+//   big2-pipeline-bench [-g games] [-j threads,...] [-f filter]
+//                       [-r repetitions] [-o results.json] [-v]
+//
+// Every configuration (players x feature sets x export x column encoding on
+// one thread or on Arrow's CPU pool) plays the same number of games from the
+// same seed, once per thread count. Each run is a child process of its own,
+// so its peak RSS is not inflated by earlier runs. Prints one line per run
+// and writes games/s, turns/s, bytes written, peak RSS and the coordinator's
+// phase metrics as JSON.
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "feature_set.h"
+#include "game_coordinator.h"
+#include "game_id_feature.h"
+#include "greedy_player_factory.h"
+#include "length_feature.h"
+#include "next_player_feature.h"
+#include "opponent_hand_size_feature.h"
+#include "outcome_feature.h"
+#include "perspective_feature.h"
+#include "player_hand_size_feature.h"
+#include "random_player_factory.h"
+#include "turn_game_id_feature.h"
+#include "turn_index_feature.h"
+#include "turn_outcome_feature.h"
+
+namespace fs = std::filesystem;
+
+static constexpr unsigned kSeed = 2024;
+
+/**
+ * @brief One fixed configuration of the pipeline.
+ */
+struct PipelineConfig {
+  std::string players;  // "random" or "greedy", on both seats
+  std::string features; // "none", "game", "turn" or "all"
+  // "none" keeps no output; "discard" extracts and encodes the features
+  // into /dev/null; "parquet" writes them to files
+  std::string output;
+  // ParquetWriterConfig::use_threads; "+mt" in the name
+  bool use_threads = false;
+
+  std::string name() const {
+    return players + "/" + features + "/" + output +
+           (use_threads ? "+mt" : "");
+  }
+};
+
+/**
+ * @brief What a child process reports back through its pipe.
+ */
+struct RunResult {
+  bool ok = false;
+  double seconds = 0.0;
+  uint64_t games = 0;
+  uint64_t turns = 0;
+};
+
+// The feature sets of the default trainer (main.cpp)
+using GameFeatures =
+    FeatureSet<GameIdFeature, OutcomeFeature, GameLengthExtractor>;
+using TurnFeatures =
+    FeatureSet<TurnGameIdFeature, TurnIndexFeature, PerspectiveFeature,
+               TurnOutcomeFeature, NextPlayerFeature, PlayerHandSizeFeature,
+               OpponentHandSizeFeature>;
+
+static std::vector<PipelineConfig> standard_configs() {
+  std::vector<PipelineConfig> configs;
+  for (const char *players : {"random", "greedy"}) {
+    configs.push_back({players, "none", "none"});
+    for (const char *features : {"game", "turn", "all"}) {
+      for (const char *output : {"discard", "parquet"}) {
+        for (bool use_threads : {false, true}) {
+          configs.push_back({players, features, output, use_threads});
+        }
+      }
+    }
+  }
+  return configs;
+}
+
+static std::shared_ptr<PlayerFactory> make_factory(const std::string &players,
+                                                   unsigned seed) {
+  if (players == "random") {
+    return std::make_shared<RandomPlayerFactory>(seed);
+  }
+  return std::make_shared<GreedyPlayerFactory>();
+}
+
+static RunResult run_config(const PipelineConfig &config, int num_games,
+                            int num_threads, const fs::path &scratch) {
+  std::shared_ptr<FeaturePipeline> game_features;
+  std::shared_ptr<FeaturePipeline> turn_features;
+  if (config.features == "game" || config.features == "all") {
+    game_features = std::make_shared<GameFeatures>();
+  }
+  if (config.features == "turn" || config.features == "all") {
+    turn_features = std::make_shared<TurnFeatures>();
+  }
+
+  GameCoordinator coordinator(make_factory(config.players, kSeed),
+                              make_factory(config.players, kSeed + 1),
+                              num_games, "", num_threads, kSeed, "",
+                              game_features, turn_features);
+  // Same encoding as the default trainer
+  ParquetWriterConfig parquet_config;
+  parquet_config.compression = arrow::Compression::ZSTD;
+  parquet_config.compression_level = 3;
+  parquet_config.row_group_size = 1 << 20;
+  parquet_config.use_threads = config.use_threads;
+  coordinator.set_parquet_config(parquet_config);
+  coordinator.set_metrics_output((scratch / "metrics.json").string());
+
+  std::string game_out = "/dev/null";
+  std::string turn_out = "/dev/null";
+  if (config.output == "parquet") {
+    game_out = (scratch / "out" / "game_features.parquet").string();
+    turn_out = (scratch / "out" / "turn_features.parquet").string();
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  coordinator.run_all(game_out, turn_out);
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  RunResult result;
+  result.seconds = elapsed.count();
+  result.games = coordinator.totals().games;
+  result.turns = coordinator.totals().turns;
+  result.ok = result.games == static_cast<uint64_t>(num_games);
+  return result;
+}
+
+/**
+ * @brief Run `config` in a child process; returns its result and peak RSS.
+ */
+static RunResult run_isolated(const PipelineConfig &config, int num_games,
+                              int num_threads, const fs::path &scratch,
+                              bool verbose, uint64_t &peak_rss_bytes) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    throw std::runtime_error(std::string("pipe: ") + std::strerror(errno));
+  }
+  std::cout.flush();
+  const pid_t pid = fork();
+  if (pid < 0) {
+    throw std::runtime_error(std::string("fork: ") + std::strerror(errno));
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    if (!verbose && !std::freopen("/dev/null", "w", stdout)) {
+      _exit(1);
+    }
+    RunResult result;
+    try {
+      result = run_config(config, num_games, num_threads, scratch);
+    } catch (const std::exception &e) {
+      std::cerr << config.name() << ": " << e.what() << std::endl;
+    }
+    const bool sent = write(fds[1], &result, sizeof(result)) ==
+                      static_cast<ssize_t>(sizeof(result));
+    _exit(sent ? 0 : 1);
+  }
+
+  close(fds[1]);
+  RunResult result;
+  const bool received = read(fds[0], &result, sizeof(result)) ==
+                        static_cast<ssize_t>(sizeof(result));
+  close(fds[0]);
+  int status = 0;
+  struct rusage usage;
+  if (wait4(pid, &status, 0, &usage) != pid) {
+    throw std::runtime_error(std::string("wait4: ") + std::strerror(errno));
+  }
+  if (!received || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    result.ok = false;
+  }
+  peak_rss_bytes = static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+  return result;
+}
+
+static uint64_t bytes_under(const fs::path &dir) {
+  uint64_t total = 0;
+  if (!fs::exists(dir)) {
+    return 0;
+  }
+  for (const auto &entry : fs::recursive_directory_iterator(dir)) {
+    if (entry.is_regular_file()) {
+      total += entry.file_size();
+    }
+  }
+  return total;
+}
+
+static std::string read_file(const fs::path &path) {
+  std::ifstream in(path);
+  std::stringstream text;
+  text << in.rdbuf();
+  return text.str();
+}
+
+static std::string cpu_model() {
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.rfind("model name", 0) == 0) {
+      const size_t colon = line.find(':');
+      if (colon != std::string::npos) {
+        return line.substr(line.find_first_not_of(' ', colon + 1));
+      }
+    }
+  }
+  return "unknown";
+}
+
+static std::string json_string(const std::string &text) {
+  std::string out = "\"";
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out + "\"";
+}
+
+static std::vector<int> parse_threads(const std::string &list) {
+  std::vector<int> threads;
+  std::stringstream in(list);
+  std::string item;
+  while (std::getline(in, item, ',')) {
+    threads.push_back(std::max(1, std::atoi(item.c_str())));
+  }
+  return threads;
+}
+
+static void usage() {
+  std::cerr << "usage: big2-pipeline-bench [-g games] [-j threads,...] "
+               "[-f filter] [-r repetitions] [-o results.json] [-v]\n";
+}
+
+int main(int argc, char **argv) {
+  int num_games = 10000;
+  const int hardware = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<int> thread_counts{1};
+  if (hardware > 1) {
+    thread_counts.push_back(hardware);
+  }
+  std::string filter;
+  int repetitions = 1;
+  std::string results_path = "pipeline_bench.json";
+  bool verbose = false;
+  for (int i = 1; i < argc; ++i) {
+    const bool has_value = i + 1 < argc;
+    if (std::strcmp(argv[i], "-v") == 0) {
+      verbose = true;
+    } else if (std::strcmp(argv[i], "-g") == 0 && has_value) {
+      num_games = std::max(1, std::atoi(argv[++i]));
+    } else if (std::strcmp(argv[i], "-j") == 0 && has_value) {
+      thread_counts = parse_threads(argv[++i]);
+    } else if (std::strcmp(argv[i], "-f") == 0 && has_value) {
+      filter = argv[++i];
+    } else if (std::strcmp(argv[i], "-r") == 0 && has_value) {
+      repetitions = std::max(1, std::atoi(argv[++i]));
+    } else if (std::strcmp(argv[i], "-o") == 0 && has_value) {
+      results_path = argv[++i];
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  const fs::path scratch = fs::temp_directory_path() /
+                           ("big2-pipeline-bench-" + std::to_string(getpid()));
+  std::ofstream results(results_path);
+  if (!results) {
+    std::cerr << "Could not open " << results_path << "\n";
+    return 1;
+  }
+  results << std::setprecision(10);
+  results << "{\n";
+  results << "  \"seed\": " << kSeed << ",\n";
+  results << "  \"games\": " << num_games << ",\n";
+  results << "  \"cpu\": " << json_string(cpu_model()) << ",\n";
+  results << "  \"hardware_threads\": " << hardware << ",\n";
+  results << "  \"compiler\": " << json_string(__VERSION__) << ",\n";
+  results << "  \"runs\": [";
+
+  std::cout << std::left << std::setw(24) << "config" << std::right
+            << std::setw(8) << "threads" << std::setw(12) << "games/s"
+            << std::setw(12) << "turns/s" << std::setw(12) << "MB written"
+            << std::setw(12) << "peak MB" << "\n";
+  bool first = true;
+  bool all_ok = true;
+  for (const auto &config : standard_configs()) {
+    if (config.name().find(filter) == std::string::npos) {
+      continue;
+    }
+    for (int threads : thread_counts) {
+      for (int rep = 0; rep < repetitions; ++rep) {
+        fs::remove_all(scratch);
+        fs::create_directories(scratch / "out");
+        uint64_t peak_rss = 0;
+        const RunResult run =
+            run_isolated(config, num_games, threads, scratch, verbose,
+                         peak_rss);
+        const uint64_t bytes = bytes_under(scratch / "out");
+        const double games_per_second =
+            run.seconds > 0.0 ? run.games / run.seconds : 0.0;
+        const double turns_per_second =
+            run.seconds > 0.0 ? run.turns / run.seconds : 0.0;
+        all_ok = all_ok && run.ok;
+
+        std::cout << std::left << std::setw(24) << config.name()
+                  << std::right << std::setw(8) << threads << std::fixed
+                  << std::setprecision(0) << std::setw(12)
+                  << games_per_second << std::setw(12) << turns_per_second
+                  << std::setprecision(2) << std::setw(12) << bytes / 1e6
+                  << std::setprecision(1) << std::setw(12) << peak_rss / 1e6
+                  << (run.ok ? "" : "  FAILED") << std::defaultfloat
+                  << std::endl;
+
+        results << (first ? "\n" : ",\n") << "    {\"config\": "
+                << json_string(config.name())
+                << ", \"players\": " << json_string(config.players)
+                << ", \"features\": " << json_string(config.features)
+                << ", \"output\": " << json_string(config.output)
+                << ", \"use_threads\": "
+                << (config.use_threads ? "true" : "false")
+                << ", \"threads\": " << threads
+                << ", \"repetition\": " << rep
+                << ", \"ok\": " << (run.ok ? "true" : "false")
+                << ", \"seconds\": " << run.seconds
+                << ", \"games\": " << run.games
+                << ", \"turns\": " << run.turns
+                << ", \"games_per_second\": " << games_per_second
+                << ", \"turns_per_second\": " << turns_per_second
+                << ", \"bytes_written\": " << bytes
+                << ", \"peak_rss_bytes\": " << peak_rss;
+        const std::string metrics = read_file(scratch / "metrics.json");
+        if (run.ok && !metrics.empty()) {
+          results << ", \"metrics\": " << metrics;
+        }
+        results << "}";
+        first = false;
+      }
+    }
+  }
+  results << "\n  ]\n}\n";
+  fs::remove_all(scratch);
+  std::cout << "Results written to " << results_path << "\n";
+  return all_ok ? 0 : 1;
+}
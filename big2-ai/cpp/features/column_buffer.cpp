@@ -0,0 +1,64 @@
+// column_buffer.cpp
+#include "column_buffer.h"
+
+static std::shared_ptr<arrow::DataType> to_arrow_value_type(ColumnType type) {
+  switch (type) {
+  case ColumnType::kBool:
+    return arrow::boolean();
+  case ColumnType::kInt8:
+    return arrow::int8();
+  case ColumnType::kInt16:
+    return arrow::int16();
+  case ColumnType::kInt32:
+    return arrow::int32();
+  case ColumnType::kInt64:
+    return arrow::int64();
+  case ColumnType::kFloat32:
+    return arrow::float32();
+  }
+  throw std::invalid_argument("Unknown column type.");
+}
+
+std::shared_ptr<arrow::DataType> to_arrow_type(const ColumnSpec &spec) {
+  auto value_type = to_arrow_value_type(spec.type);
+  if (spec.list_size > 1) {
+    return arrow::fixed_size_list(value_type, spec.list_size);
+  }
+  return value_type;
+}
+
+ColumnBuffer::ColumnBuffer(const ColumnSpec &spec, size_t num_rows)
+    : _spec(spec), _num_rows(num_rows) {
+  if (_spec.list_size < 1) {
+    throw std::invalid_argument("ColumnSpec: list_size must be positive.");
+  }
+  _data.resize(num_values() * column_type_width(_spec.type));
+}
+
+std::shared_ptr<arrow::Array> ColumnBuffer::Finish() {
+  const int64_t num_values = static_cast<int64_t>(this->num_values());
+  std::shared_ptr<arrow::Buffer> values;
+
+  if (_spec.type == ColumnType::kBool) {
+    // Pack one byte per value into Arrow's validity-style bitmap
+    std::vector<uint8_t> bits((num_values + 7) / 8, 0);
+    for (int64_t i = 0; i < num_values; ++i) {
+      bits[i >> 3] |= static_cast<uint8_t>(_data[i] << (i & 7));
+    }
+    values = arrow::Buffer::FromVector(std::move(bits));
+  } else {
+    values = arrow::Buffer::FromVector(std::move(_data));
+  }
+  _data = {};
+
+  auto value_data = arrow::ArrayData::Make(to_arrow_value_type(_spec.type),
+                                           num_values, {nullptr, values}, 0);
+  if (_spec.list_size == 1) {
+    return arrow::MakeArray(value_data);
+  }
+  auto list_data =
+      arrow::ArrayData::Make(to_arrow_type(_spec),
+                             static_cast<int64_t>(_num_rows), {nullptr},
+                             {value_data}, 0);
+  return arrow::MakeArray(list_data);
+}
@@ -0,0 +1,169 @@
+// column_buffer.h
+#ifndef COLUMN_BUFFER_H
+#define COLUMN_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <arrow/api.h>
+
+/**
+ * @brief Physical type of a feature column.
+ * Exporters map these one-to-one onto Arrow types.
+ */
+enum class ColumnType { kBool, kInt8, kInt16, kInt32, kInt64, kFloat32 };
+
+/**
+ * @brief Encoding hint for file formats that support per-column encodings.
+ * Explicit writer configuration takes precedence over the hint.
+ * kDictionary suits columns with few distinct values (counts, flags): the
+ * dictionary indices are RLE/bit-packed to a few bits per value.
+ */
+enum class ColumnEncoding { kDefault, kDictionary, kPlain, kByteStreamSplit };
+
+/**
+ * @brief Declares how a feature is stored.
+ * A list_size greater than 1 exports as a fixed-size list of `type`.
+ */
+struct ColumnSpec {
+  ColumnType type = ColumnType::kInt32;
+  int list_size = 1;
+  ColumnEncoding encoding = ColumnEncoding::kDefault;
+};
+
+/**
+ * @brief Width in bytes of one value while it is being filled.
+ * Booleans use one byte per value and are bit-packed on Finish().
+ */
+constexpr int column_type_width(ColumnType type) {
+  switch (type) {
+  case ColumnType::kInt16:
+    return 2;
+  case ColumnType::kInt32:
+  case ColumnType::kFloat32:
+    return 4;
+  case ColumnType::kInt64:
+    return 8;
+  default:
+    return 1;
+  }
+}
+
+/**
+ * @brief Arrow type matching a column spec.
+ */
+std::shared_ptr<arrow::DataType> to_arrow_type(const ColumnSpec &spec);
+
+/**
+ * @brief Fixed-size, typed storage for one feature column.
+ * Sized up front; filled through ColumnSinks; handed to Arrow without copying.
+ */
+class ColumnBuffer {
+public:
+  ColumnBuffer(const ColumnSpec &spec, size_t num_rows);
+
+  const ColumnSpec &spec() const { return _spec; }
+  size_t num_rows() const { return _num_rows; }
+  size_t num_values() const { return _num_rows * _spec.list_size; }
+
+  uint8_t *data() { return _data.data(); }
+  const uint8_t *data() const { return _data.data(); }
+
+  /**
+   * @brief Convert to an Arrow array. The buffer is empty afterwards.
+   */
+  std::shared_ptr<arrow::Array> Finish();
+
+private:
+  ColumnSpec _spec;
+  size_t _num_rows;
+  std::vector<uint8_t> _data;
+};
+
+/**
+ * @brief Append-only cursor over a range of values in a ColumnBuffer.
+ * Extractors write values in row order; each value is narrowed to the column
+ * type on the way in.
+ */
+class ColumnSink {
+public:
+  explicit ColumnSink(ColumnBuffer &buffer)
+      : ColumnSink(buffer, 0, buffer.num_rows()) {}
+
+  /**
+   * @param buffer    Column to write into.
+   * @param first_row Row at which writing starts.
+   * @param num_rows  Number of rows this sink may write.
+   */
+  ColumnSink(ColumnBuffer &buffer, size_t first_row, size_t num_rows)
+      : _type(buffer.spec().type),
+        _cursor(buffer.data() + first_row * buffer.spec().list_size *
+                                    column_type_width(_type)),
+        _end(_cursor +
+             num_rows * buffer.spec().list_size * column_type_width(_type)) {}
+
+  /**
+   * @brief Append with the column type known at compile time (no dispatch).
+   */
+  template <ColumnType T, typename V> void append_as(V value) {
+    check_capacity();
+    if constexpr (T == ColumnType::kBool) {
+      *_cursor = value != 0;
+    } else if constexpr (T == ColumnType::kInt8) {
+      *reinterpret_cast<int8_t *>(_cursor) = static_cast<int8_t>(value);
+    } else if constexpr (T == ColumnType::kInt16) {
+      *reinterpret_cast<int16_t *>(_cursor) = static_cast<int16_t>(value);
+    } else if constexpr (T == ColumnType::kInt32) {
+      *reinterpret_cast<int32_t *>(_cursor) = static_cast<int32_t>(value);
+    } else if constexpr (T == ColumnType::kInt64) {
+      *reinterpret_cast<int64_t *>(_cursor) = static_cast<int64_t>(value);
+    } else {
+      *reinterpret_cast<float *>(_cursor) = static_cast<float>(value);
+    }
+    _cursor += column_type_width(T);
+  }
+
+  template <typename V> void append(V value) {
+    switch (_type) {
+    case ColumnType::kBool:
+      append_as<ColumnType::kBool>(value);
+      break;
+    case ColumnType::kInt8:
+      append_as<ColumnType::kInt8>(value);
+      break;
+    case ColumnType::kInt16:
+      append_as<ColumnType::kInt16>(value);
+      break;
+    case ColumnType::kInt32:
+      append_as<ColumnType::kInt32>(value);
+      break;
+    case ColumnType::kInt64:
+      append_as<ColumnType::kInt64>(value);
+      break;
+    case ColumnType::kFloat32:
+      append_as<ColumnType::kFloat32>(value);
+      break;
+    }
+  }
+
+  /**
+   * @brief True once every row in the sink's range has been written.
+   */
+  bool full() const { return _cursor == _end; }
+
+private:
+  ColumnType _type;
+  uint8_t *_cursor;
+  uint8_t *_end;
+
+  void check_capacity() const {
+    if (_cursor >= _end) {
+      throw std::out_of_range("ColumnSink: write past end of column.");
+    }
+  }
+};
+
+#endif // COLUMN_BUFFER_H
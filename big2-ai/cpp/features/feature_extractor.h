@@ -6,14 +6,18 @@
 #include <vector>
 
 #include "../game_record.h"
+#include "column_buffer.h"
 
 class GameRecord;
-class TurnRecord;
+struct TurnRecord;
 
 class FeatureExtractor {
 public:
   enum class Type { GameLevel, TurnLevel };
 
+  // Turn-level features emit one row per turn for each perspective
+  static constexpr int kPerspectives = 2;
+
   virtual ~FeatureExtractor() = default;
 
   // Identify feature type
@@ -22,6 +26,13 @@ public:
   // Canonical column name for output
   virtual std::string name() const = 0;
 
+  // Column type for output (int32 unless the feature narrows it)
+  virtual ColumnSpec column() const { return {}; }
+
+  // TurnRecord fields the feature reads (RecordFields bits); the simulator
+  // records only what some feature needs
+  virtual uint32_t required_fields() const { return RecordFields::kAll; }
+
   // --------- Game-level: One value per game ----------
   virtual int gameExtract(const GameRecord &game) const {
     throw std::logic_error("Game-level extract() not implemented.");
@@ -32,6 +43,84 @@ public:
   virtual std::vector<int> turnExtract(const GameRecord &game) const {
     throw std::logic_error("Turn-level extract() not implemented.");
   }
+
+  // --------- Typed output: write this game's rows into a column sink
+  // ----------
+  virtual void gameExtractInto(const GameRecord &game,
+                               ColumnSink &sink) const {
+    sink.append(gameExtract(game));
+  }
+
+  virtual void turnExtractInto(const GameRecord &game,
+                               ColumnSink &sink) const {
+    for (int value : turnExtract(game)) {
+      sink.append(value);
+    }
+  }
+};
+
+/**
+ * @brief Base for game-level features with a statically known column.
+ *
+ * Derived classes provide `kName`, `kColumn` and a static
+ * `value(const GameRecord &)`, and may narrow `kFields` to the TurnRecord
+ * fields they read. The same definition serves the virtual
+ * interface (plug-ins, runtime lists) and FeatureSet, which calls `write()`
+ * directly and inlines it.
+ */
+template <typename Derived> class GameFeature : public FeatureExtractor {
+public:
+  static constexpr Type kType = Type::GameLevel;
+  static constexpr uint32_t kFields = RecordFields::kAll;
+
+  Type type() const override { return kType; }
+  std::string name() const override { return Derived::kName; }
+  ColumnSpec column() const override { return Derived::kColumn; }
+  uint32_t required_fields() const override { return Derived::kFields; }
+
+  static void write(const GameRecord &record, ColumnSink &sink) {
+    sink.append_as<Derived::kColumn.type>(Derived::value(record));
+  }
+
+  void gameExtractInto(const GameRecord &record,
+                       ColumnSink &sink) const override {
+    Derived::write(record, sink);
+  }
+};
+
+/**
+ * @brief Base for turn-level features with a statically known column.
+ *
+ * Derived classes provide `kName`, `kColumn` and a static
+ * `value(const GameRecord &, const TurnRecord &, int perspective)`;
+ * list-valued features replace `write()` instead. `kFields` as for
+ * GameFeature.
+ */
+template <typename Derived> class TurnFeature : public FeatureExtractor {
+public:
+  static constexpr Type kType = Type::TurnLevel;
+  static constexpr uint32_t kFields = RecordFields::kAll;
+
+  Type type() const override { return kType; }
+  std::string name() const override { return Derived::kName; }
+  ColumnSpec column() const override { return Derived::kColumn; }
+  uint32_t required_fields() const override { return Derived::kFields; }
+
+  static void write(const GameRecord &record, const TurnRecord &turn,
+                    int perspective, ColumnSink &sink) {
+    sink.append_as<Derived::kColumn.type>(
+        Derived::value(record, turn, perspective));
+  }
+
+  // Writes two rows per turn: perspective 0, then perspective 1
+  void turnExtractInto(const GameRecord &record,
+                       ColumnSink &sink) const override {
+    for (const auto &turn : record.turns()) {
+      for (int perspective = 0; perspective < kPerspectives; ++perspective) {
+        Derived::write(record, turn, perspective, sink);
+      }
+    }
+  }
 };
 
 #endif // FEATURE_EXTRACTOR_H
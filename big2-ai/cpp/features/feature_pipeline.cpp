@@ -0,0 +1,169 @@
+// feature_pipeline.cpp
+#include "feature_pipeline.h"
+
+#include <algorithm>
+#include <iostream>
+#include <omp.h>
+#include <stdexcept>
+
+#include "perf_profiler.h"
+#include "thread_name.h"
+#include "trace_recorder.h"
+
+std::shared_ptr<arrow::Schema> FeaturePipeline::schema() const {
+  auto column_names = names();
+  auto column_specs = columns();
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (size_t c = 0; c < column_specs.size(); ++c) {
+    fields.push_back(
+        arrow::field(column_names[c], to_arrow_type(column_specs[c])));
+  }
+  return arrow::schema(fields);
+}
+
+std::vector<ColumnBuffer>
+FeaturePipeline::extract_columns(const std::vector<GameRecord> &records,
+                                 const std::vector<size_t> &row_offsets,
+                                 int num_threads) const {
+  const size_t num_records = records.size();
+  const size_t total_rows = row_offsets.back();
+
+  std::vector<ColumnBuffer> buffers;
+  for (const auto &spec : columns()) {
+    buffers.emplace_back(spec, total_rows);
+  }
+
+  // One contiguous record range per thread; record i owns rows
+  // [row_offsets[i], row_offsets[i + 1]) so every thread fills a disjoint
+  // slice of each column in place and nothing has to be stitched afterwards
+  const int num_chunks =
+      static_cast<int>(std::min<size_t>(num_threads, num_records));
+  std::vector<std::string> errors(num_chunks);
+
+#pragma omp parallel for num_threads(num_threads) schedule(static, 1)
+  for (int c = 0; c < num_chunks; ++c) {
+    const size_t begin = num_records * c / num_chunks;
+    const size_t end = num_records * (c + 1) / num_chunks;
+    const size_t first_row = row_offsets[begin];
+    const size_t num_rows = row_offsets[end] - first_row;
+
+    // Thread 0 is the caller, which keeps its own name
+    if (omp_get_thread_num() != 0 && ThreadName::get().empty()) {
+      ThreadName::set("extract " + std::to_string(omp_get_thread_num()));
+    }
+    TraceSpan span("extract_chunk");
+    BIG2_PERF_REGION(kExtract);
+    try {
+      std::vector<ColumnSink> sinks;
+      for (auto &buffer : buffers) {
+        sinks.emplace_back(buffer, first_row, num_rows);
+      }
+      extract(records.data() + begin, end - begin, sinks);
+      for (size_t f = 0; f < sinks.size(); ++f) {
+        if (!sinks[f].full()) {
+          throw std::runtime_error("Feature column " + std::to_string(f) +
+                                   " has fewer rows than expected");
+        }
+      }
+    } catch (const std::exception &e) {
+      // Exceptions must not escape an OpenMP region
+      errors[c] = e.what();
+    }
+  }
+
+  for (const auto &error : errors) {
+    if (!error.empty()) {
+      throw std::runtime_error(error);
+    }
+  }
+  return buffers;
+}
+
+std::shared_ptr<arrow::Table>
+FeaturePipeline::build_table(const std::vector<GameRecord> &records,
+                             int num_threads,
+                             RunMetrics::Counters *metrics) const {
+  // Game-level features have one row per game; turn-level features one row
+  // per turn and perspective. A prefix sum over row counts gives each game
+  // its first row so games can be filled in parallel.
+  std::vector<size_t> row_offsets(records.size() + 1, 0);
+  for (size_t i = 0; i < records.size(); ++i) {
+    row_offsets[i + 1] = row_offsets[i] + rows_for(records[i]);
+  }
+  const size_t total_rows = row_offsets.back();
+
+  std::vector<ColumnBuffer> buffers;
+  {
+    RunMetrics::ScopedTimer timer(metrics, RunMetrics::kExtract);
+    TraceSpan span("extract_batch");
+    buffers = extract_columns(records, row_offsets, num_threads);
+  }
+
+  RunMetrics::ScopedTimer timer(metrics, RunMetrics::kBuildTable);
+  std::vector<std::shared_ptr<arrow::Array>> arrays;
+  for (auto &buffer : buffers) {
+    TraceSpan span("build_column");
+    arrays.push_back(buffer.Finish());
+  }
+  return arrow::Table::Make(schema(), arrays, total_rows);
+}
+
+ExtractorListPipeline::ExtractorListPipeline(
+    FeatureExtractor::Type type,
+    std::vector<std::shared_ptr<FeatureExtractor>> extractors)
+    : _type(type) {
+  for (size_t f = 0; f < extractors.size(); ++f) {
+    if (!extractors[f]) {
+      std::cerr << "Warning: Null feature extractor at index " << f
+                << ", skipping.\n";
+      continue;
+    }
+    if (extractors[f]->type() != type) {
+      std::cerr << "Warning: Feature " << extractors[f]->name()
+                << " has the wrong level for this list, skipping.\n";
+      continue;
+    }
+    _extractors.push_back(std::move(extractors[f]));
+  }
+}
+
+std::vector<std::string> ExtractorListPipeline::names() const {
+  std::vector<std::string> result;
+  for (const auto &extractor : _extractors) {
+    result.push_back(extractor->name());
+  }
+  return result;
+}
+
+std::vector<ColumnSpec> ExtractorListPipeline::columns() const {
+  std::vector<ColumnSpec> result;
+  for (const auto &extractor : _extractors) {
+    result.push_back(extractor->column());
+  }
+  return result;
+}
+
+uint32_t ExtractorListPipeline::required_fields() const {
+  uint32_t fields = RecordFields::kNone;
+  for (const auto &extractor : _extractors) {
+    fields |= extractor->required_fields();
+  }
+  return fields;
+}
+
+void ExtractorListPipeline::extract(const GameRecord *records, size_t count,
+                                    std::vector<ColumnSink> &sinks) const {
+  // Column-major: one extractor at a time over the whole slice
+  for (size_t f = 0; f < _extractors.size(); ++f) {
+    const FeatureExtractor &extractor = *_extractors[f];
+    if (_type == FeatureExtractor::Type::GameLevel) {
+      for (size_t i = 0; i < count; ++i) {
+        extractor.gameExtractInto(records[i], sinks[f]);
+      }
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        extractor.turnExtractInto(records[i], sinks[f]);
+      }
+    }
+  }
+}
@@ -0,0 +1,100 @@
+// feature_pipeline.h
+#ifndef FEATURE_PIPELINE_H
+#define FEATURE_PIPELINE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "column_buffer.h"
+#include "feature_extractor.h"
+#include "run_metrics.h"
+
+/**
+ * @brief A fixed list of features of one level, extracted together.
+ *
+ * The exporter calls extract() once per slice of records, so the cost of the
+ * virtual call is paid per slice rather than per value.
+ */
+class FeaturePipeline {
+public:
+  virtual ~FeaturePipeline() = default;
+
+  virtual FeatureExtractor::Type type() const = 0;
+
+  /**
+   * @brief Output columns, in order.
+   */
+  virtual std::vector<std::string> names() const = 0;
+  virtual std::vector<ColumnSpec> columns() const = 0;
+
+  /**
+   * @brief Union of the TurnRecord fields (RecordFields bits) the features
+   * read.
+   */
+  virtual uint32_t required_fields() const { return RecordFields::kAll; }
+
+  /**
+   * @brief Write every row of records[0, count) into the sinks, one sink per
+   * column.
+   */
+  virtual void extract(const GameRecord *records, size_t count,
+                       std::vector<ColumnSink> &sinks) const = 0;
+
+  size_t num_columns() const { return columns().size(); }
+
+  /**
+   * @brief Rows contributed by one game (1, or one per turn per perspective).
+   */
+  size_t rows_for(const GameRecord &record) const {
+    return type() == FeatureExtractor::Type::GameLevel
+               ? 1
+               : record.turns().size() * FeatureExtractor::kPerspectives;
+  }
+
+  /**
+   * @brief Arrow schema matching names() and columns().
+   */
+  std::shared_ptr<arrow::Schema> schema() const;
+
+  /**
+   * @brief Extract every row of `records` into an Arrow table, splitting the
+   * records across `num_threads` OpenMP threads. Extraction and Arrow
+   * assembly are timed into `metrics` if given.
+   */
+  std::shared_ptr<arrow::Table>
+  build_table(const std::vector<GameRecord> &records, int num_threads,
+              RunMetrics::Counters *metrics = nullptr) const;
+
+private:
+  std::vector<ColumnBuffer>
+  extract_columns(const std::vector<GameRecord> &records,
+                  const std::vector<size_t> &row_offsets,
+                  int num_threads) const;
+};
+
+/**
+ * @brief Runtime-polymorphic pipeline over a list of extractors.
+ * Used for plug-in features whose types are not known at compile time.
+ */
+class ExtractorListPipeline : public FeaturePipeline {
+public:
+  ExtractorListPipeline(
+      FeatureExtractor::Type type,
+      std::vector<std::shared_ptr<FeatureExtractor>> extractors);
+
+  FeatureExtractor::Type type() const override { return _type; }
+  std::vector<std::string> names() const override;
+  std::vector<ColumnSpec> columns() const override;
+  uint32_t required_fields() const override;
+  void extract(const GameRecord *records, size_t count,
+               std::vector<ColumnSink> &sinks) const override;
+
+private:
+  FeatureExtractor::Type _type;
+  std::vector<std::shared_ptr<FeatureExtractor>> _extractors;
+};
+
+#endif // FEATURE_PIPELINE_H
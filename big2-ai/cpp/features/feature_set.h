@@ -0,0 +1,83 @@
+// feature_set.h
+#ifndef FEATURE_SET_H
+#define FEATURE_SET_H
+
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "feature_pipeline.h"
+
+/**
+ * @brief Compile-time feature pipeline.
+ *
+ * FeatureSet<OutcomeFeature, GameLengthExtractor> knows its column names and
+ * types statically and extracts every feature in a single loop over games
+ * (or over turns and perspectives), calling each feature's static write()
+ * directly so the compiler can inline it. All features must be of the same
+ * level and derive from GameFeature / TurnFeature.
+ */
+template <typename... Features> class FeatureSet : public FeaturePipeline {
+  static_assert(sizeof...(Features) > 0, "FeatureSet needs a feature.");
+
+  static constexpr FeatureExtractor::Type kLevels[] = {Features::kType...};
+
+  static constexpr bool same_level() {
+    for (auto level : kLevels) {
+      if (level != kLevels[0]) {
+        return false;
+      }
+    }
+    return true;
+  }
+  static_assert(same_level(), "FeatureSet mixes game and turn features.");
+
+public:
+  static constexpr FeatureExtractor::Type kType = kLevels[0];
+  static constexpr size_t kNumColumns = sizeof...(Features);
+  static constexpr std::array<const char *, kNumColumns> kNames = {
+      Features::kName...};
+  static constexpr std::array<ColumnSpec, kNumColumns> kColumns = {
+      Features::kColumn...};
+  static constexpr uint32_t kFields = (Features::kFields | ...);
+
+  FeatureExtractor::Type type() const override { return kType; }
+
+  std::vector<std::string> names() const override {
+    return {kNames.begin(), kNames.end()};
+  }
+
+  std::vector<ColumnSpec> columns() const override {
+    return {kColumns.begin(), kColumns.end()};
+  }
+
+  uint32_t required_fields() const override { return kFields; }
+
+  void extract(const GameRecord *records, size_t count,
+               std::vector<ColumnSink> &sinks) const override {
+    extract_impl(records, count, sinks.data(),
+                 std::index_sequence_for<Features...>{});
+  }
+
+private:
+  template <size_t... I>
+  static void extract_impl(const GameRecord *records, size_t count,
+                           ColumnSink *sinks, std::index_sequence<I...>) {
+    for (size_t i = 0; i < count; ++i) {
+      const GameRecord &record = records[i];
+      if constexpr (kType == FeatureExtractor::Type::GameLevel) {
+        (Features::write(record, sinks[I]), ...);
+      } else {
+        for (const auto &turn : record.turns()) {
+          for (int perspective = 0;
+               perspective < FeatureExtractor::kPerspectives; ++perspective) {
+            (Features::write(record, turn, perspective, sinks[I]), ...);
+          }
+        }
+      }
+    }
+  }
+};
+
+#endif // FEATURE_SET_H
@@ -0,0 +1,21 @@
+#ifndef GAME_ID_FEATURE_H
+#define GAME_ID_FEATURE_H
+
+#include "feature_extractor.h"
+#include "game_record.h"
+
+/**
+ * @brief Game-level key: the run-wide game id, for joining outputs.
+ */
+class GameIdFeature : public GameFeature<GameIdFeature> {
+public:
+  static constexpr const char *kName = "game_id";
+  static constexpr ColumnSpec kColumn{ColumnType::kInt64};
+  static constexpr uint32_t kFields = RecordFields::kNone;
+
+  static int64_t value(const GameRecord &game) {
+    return static_cast<int64_t>(game.game_id());
+  }
+};
+
+#endif // GAME_ID_FEATURE_H
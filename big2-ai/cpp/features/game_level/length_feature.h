@@ -4,13 +4,13 @@
 #include "feature_extractor.h"
 #include "game_record.h"
 
-class GameLengthExtractor : public FeatureExtractor {
+class GameLengthExtractor : public GameFeature<GameLengthExtractor> {
 public:
-  Type type() const override { return Type::GameLevel; }
+  static constexpr const char *kName = "game_length";
+  static constexpr ColumnSpec kColumn{ColumnType::kInt16};
+  static constexpr uint32_t kFields = RecordFields::kNone;
 
-  std::string name() const override { return "game_length"; }
-
-  int gameExtract(const GameRecord &game) const override {
+  static int value(const GameRecord &game) {
     return static_cast<int>(game.turns().size());
   }
 };
@@ -4,13 +4,13 @@
 
 #include "../feature_extractor.h"
 
-class OutcomeFeature : public FeatureExtractor {
+class OutcomeFeature : public GameFeature<OutcomeFeature> {
 public:
-  Type type() const override { return Type::GameLevel; }
+  static constexpr const char *kName = "outcome";
+  static constexpr ColumnSpec kColumn{ColumnType::kInt8};
+  static constexpr uint32_t kFields = RecordFields::kNone;
 
-  std::string name() const override { return "outcome"; }
-
-  int gameExtract(const GameRecord &record) const override {
+  static int value(const GameRecord &record) {
     return record.game().get_winner();
   }
 };
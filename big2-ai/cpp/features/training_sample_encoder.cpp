@@ -0,0 +1,99 @@
+// training_sample_encoder.cpp
+#include "training_sample_encoder.h"
+
+#include <algorithm>
+
+using Combination = Move::Combination;
+
+static constexpr int kFullHandSize = 16;
+
+// Slot of the one-hot combination block, or -1 (pass and double straights
+// of 8 have none)
+static int combination_slot(Combination c) {
+  if (c == Combination::kPass || c == Combination::kDoubleStraight8)
+    return -1;
+  if (c <= Combination::kBomb)
+    return static_cast<int>(c) - static_cast<int>(Combination::kSingle);
+  if (c <= Combination::kStraight13)
+    return 5;
+  if (c <= Combination::kDoubleStraight7)
+    return 6;
+  return 7;
+}
+
+// Number of consecutive ranks of a straight-type move; 0 otherwise and, as
+// in the old trainer, for double straights of 8
+static int sequence_length(Combination c) {
+  if (c >= Combination::kStraight5 && c <= Combination::kStraight13)
+    return 5 + static_cast<int>(c) - static_cast<int>(Combination::kStraight5);
+  if (c >= Combination::kDoubleStraight2 && c <= Combination::kDoubleStraight7)
+    return 2 + static_cast<int>(c) -
+           static_cast<int>(Combination::kDoubleStraight2);
+  if (c >= Combination::kTripleStraight2)
+    return 2 + static_cast<int>(c) -
+           static_cast<int>(Combination::kTripleStraight2);
+  return 0;
+}
+
+bool TrainingSampleEncoder::has_player_sample(const TurnRecord &turn) {
+  const Move &move = turn.move;
+  return move.combination != Combination::kPass &&
+         move.combination != Combination::kDoubleStraight8 &&
+         move.numCards() < turn.game.get_player_hand_size(turn.current_player);
+}
+
+bool TrainingSampleEncoder::has_opponent_sample(const TurnRecord &turn) {
+  const bool first_move =
+      turn.game.get_player_hand_size(0) == kFullHandSize &&
+      turn.game.get_player_hand_size(1) == kFullHandSize;
+  return !first_move && turn.possible_moves.size() > 1;
+}
+
+void TrainingSampleEncoder::encode_state(const TurnRecord &turn, int head,
+                                         float *out) {
+  std::fill(out, out + kStateSize, 0.0f);
+  const int player = seat(turn, head);
+  const auto hand = turn.game.player_hand(player);
+  const Move last = turn.game.last_move();
+
+  // 0: head
+  out[0] = static_cast<float>(head);
+  // 1..13: own hand by rank, normalised by the number of copies in the deck
+  for (int r = 0; r < 11; ++r) {
+    out[1 + r] = hand[r] / 4.0f;
+  }
+  out[12] = hand[11] / 3.0f;
+  out[13] = static_cast<float>(hand[12]);
+  // 14..21: one-hot combination of the move played
+  const int slot = combination_slot(turn.move.combination);
+  if (slot >= 0) {
+    out[14 + slot] = 1.0f;
+  }
+  // 22: primary rank, 23: sequence length, 24: auxiliary rank of the move
+  // to beat
+  if (last.combination != Combination::kPass) {
+    out[22] = (last.rank - 3) / 12.0f;
+  }
+  const int length = sequence_length(last.combination);
+  if (length > 0) {
+    out[23] = (length - 1) / 12.0f;
+  }
+  if (last.combination == Combination::kFullHouse ||
+      last.combination == Combination::kBomb) {
+    out[24] = (last.auxiliary - 3) / 12.0f;
+  }
+  // 25: opponent hand size
+  out[25] = turn.game.get_player_hand_size(1 - player) / 16.0f;
+}
+
+void TrainingSampleEncoder::encode_legal_mask(const TurnRecord &turn, int head,
+                                              uint8_t *out) {
+  std::fill(out, out + kMaskSize, uint8_t{0});
+  const auto &moves =
+      head == kPlayerHead ? turn.legal_moves : turn.possible_moves;
+  for (int move : moves) {
+    if (move < kMaskSize) {
+      out[move] = 1;
+    }
+  }
+}
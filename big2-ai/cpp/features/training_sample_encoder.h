@@ -0,0 +1,75 @@
+// training_sample_encoder.h
+#ifndef TRAINING_SAMPLE_ENCODER_H
+#define TRAINING_SAMPLE_ENCODER_H
+
+#include <cstdint>
+
+#include "../game_record.h"
+#include "../util.h"
+
+/**
+ * @brief Encodes turns as the samples of the old trainer
+ * (old_trainer/util.cpp, Sample::writeSample).
+ *
+ * A turn gives up to two samples, one per network head:
+ *  - kPlayerHead: the mover's own choice, unless the move is a pass, a
+ *    double straight of 8 or plays out the mover's whole hand;
+ *  - kOpponentHead: the other player predicting the move from the moves
+ *    the mover could possibly hold, except on the first move of a game and
+ *    when only one such move exists.
+ * Within a game, samples follow the turns, the player head first.
+ *
+ * Each sample is, seen from its head's player:
+ *  - state:      float32[kStateSize]  own hand, combination of the move
+ *                played, last move to beat, opponent hand size
+ *  - turn:       the head (0 opponent, 1 player), also in state[0]
+ *  - legal mask: [kMaskSize]  1 where the move id is legal (player head) or
+ *                possible for the mover (opponent head)
+ *  - value:      float32  +1 if the head's player went on to win, else -1
+ *  - move:       encodeMove() of the move played; may be a double straight
+ *                of 8 (>= kMaskSize) on the opponent head, as before
+ *
+ * Deviations from the old trainer: the masks come from this engine's
+ * move generator, which lists other possible moves (mostly full houses)
+ * for about one opponent-head row in four, and a bomb's kicker leaves the
+ * hand here, so states after a bomb differ.
+ */
+class TrainingSampleEncoder {
+public:
+  static constexpr int kStateSize = 26;
+  // Move ids the network scores: all but the double straights of 8, which
+  // come last (the old trainer's NEURAL_NETWORK_MOVES_SIZE)
+  static constexpr int kMaskSize = 467;
+  static constexpr int kOpponentHead = 0;
+  static constexpr int kPlayerHead = 1;
+  // TurnRecord fields read by the encoders
+  static constexpr uint32_t kFields = RecordFields::kGame |
+                                      RecordFields::kLegalMoves |
+                                      RecordFields::kPossibleMoves;
+
+  static bool has_player_sample(const TurnRecord &turn);
+  static bool has_opponent_sample(const TurnRecord &turn);
+
+  /**
+   * @brief Player whose point of view `head` takes on this turn.
+   */
+  static int seat(const TurnRecord &turn, int head) {
+    return head == kPlayerHead ? turn.current_player
+                               : 1 - turn.current_player;
+  }
+
+  static void encode_state(const TurnRecord &turn, int head, float *out);
+  static void encode_legal_mask(const TurnRecord &turn, int head,
+                                uint8_t *out);
+
+  static float encode_value(const GameRecord &record, const TurnRecord &turn,
+                            int head) {
+    return record.game().get_winner() == seat(turn, head) ? 1.0f : -1.0f;
+  }
+
+  static int16_t encode_move(const TurnRecord &turn) {
+    return static_cast<int16_t>(encodeMove(turn.move));
+  }
+};
+
+#endif // TRAINING_SAMPLE_ENCODER_H
@@ -9,20 +9,15 @@
  * @brief Turn-level feature: 1 if it's this player's turn to move, else 0.
  * For each turn, outputs for both perspectives (player 0 and 1).
  */
-class NextPlayerFeature : public FeatureExtractor {
+class NextPlayerFeature : public TurnFeature<NextPlayerFeature> {
 public:
-  Type type() const override { return Type::TurnLevel; }
-  std::string name() const override { return "next_player"; }
+  static constexpr const char *kName = "next_player";
+  static constexpr ColumnSpec kColumn{ColumnType::kBool};
+  static constexpr uint32_t kFields = RecordFields::kNone;
 
-  std::vector<int> turnExtract(const GameRecord &game) const override {
-    std::vector<int> features;
-    const auto &turns = game.turns();
-    for (const auto &turn : turns) {
-      for (int perspective = 0; perspective < 2; ++perspective) {
-        features.push_back(turn.current_player == perspective ? 1 : 0);
-      }
-    }
-    return features;
+  static bool value(const GameRecord &, const TurnRecord &turn,
+                    int perspective) {
+    return turn.current_player == perspective;
   }
 };
 
@@ -0,0 +1,22 @@
+// perspective_feature.h
+
+#ifndef PERSPECTIVE_FEATURE_H
+#define PERSPECTIVE_FEATURE_H
+
+#include "../feature_extractor.h"
+
+/**
+ * @brief Turn-level key: the player whose perspective the row describes.
+ */
+class PerspectiveFeature : public TurnFeature<PerspectiveFeature> {
+public:
+  static constexpr const char *kName = "perspective";
+  static constexpr ColumnSpec kColumn{ColumnType::kInt8};
+  static constexpr uint32_t kFields = RecordFields::kNone;
+
+  static int value(const GameRecord &, const TurnRecord &, int perspective) {
+    return perspective;
+  }
+};
+
+#endif // PERSPECTIVE_FEATURE_H
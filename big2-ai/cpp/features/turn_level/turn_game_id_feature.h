@@ -0,0 +1,22 @@
+// turn_game_id_feature.h
+
+#ifndef TURN_GAME_ID_FEATURE_H
+#define TURN_GAME_ID_FEATURE_H
+
+#include "../feature_extractor.h"
+
+/**
+ * @brief Turn-level key: the run-wide id of the game the turn belongs to.
+ */
+class TurnGameIdFeature : public TurnFeature<TurnGameIdFeature> {
+public:
+  static constexpr const char *kName = "game_id";
+  static constexpr ColumnSpec kColumn{ColumnType::kInt64};
+  static constexpr uint32_t kFields = RecordFields::kNone;
+
+  static int64_t value(const GameRecord &game, const TurnRecord &, int) {
+    return static_cast<int64_t>(game.game_id());
+  }
+};
+
+#endif // TURN_GAME_ID_FEATURE_H
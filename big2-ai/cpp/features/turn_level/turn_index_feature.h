@@ -0,0 +1,22 @@
+// turn_index_feature.h
+
+#ifndef TURN_INDEX_FEATURE_H
+#define TURN_INDEX_FEATURE_H
+
+#include "../feature_extractor.h"
+
+/**
+ * @brief Turn-level key: index of the turn within its game (0 = first move).
+ */
+class TurnIndexFeature : public TurnFeature<TurnIndexFeature> {
+public:
+  static constexpr const char *kName = "turn";
+  static constexpr ColumnSpec kColumn{ColumnType::kInt16};
+  static constexpr uint32_t kFields = RecordFields::kNone;
+
+  static int value(const GameRecord &game, const TurnRecord &turn, int) {
+    return static_cast<int>(&turn - game.turns().data());
+  }
+};
+
+#endif // TURN_INDEX_FEATURE_H
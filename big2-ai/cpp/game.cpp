@@ -1,5 +1,6 @@
 // game.cpp
 #include "game.h"
+#include "perf_profiler.h"
 #include "util.h"
 #include <algorithm>
 #include <cassert>
@@ -40,6 +41,14 @@ void Game::shuffle_deal(std::mt19937 &rng) {
   current_player_ = 0;
 }
 
+void Game::deal(const std::array<std::array<int, 13>, 2> &hands,
+                int first_player) {
+  hands_ = hands;
+  discard_pile_.fill(0);
+  last_move_ = Move(Move::Combination::kPass);
+  current_player_ = first_player;
+}
+
 int Game::current_player() const { return current_player_; }
 
 bool Game::is_over() const {
@@ -90,6 +99,7 @@ void Game::apply_move(const Move &move) {
 }
 
 std::vector<int> Game::get_legal_moves() const {
+  BIG2_PERF_REGION(kGameLegalMoves);
   std::vector<int> legal_moves;
   legal_moves.reserve(32);
   // We can pass if it's not a new trick (a.k.a. the last move was a pass)
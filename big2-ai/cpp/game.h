@@ -25,6 +25,14 @@ public:
    */
   void shuffle_deal(std::mt19937 &rng);
 
+  /**
+   * @brief Start a game from known hands, e.g. when replaying a record.
+   * @param hands Rank counts of each player's hand.
+   * @param first_player Player to move first.
+   */
+  void deal(const std::array<std::array<int, 13>, 2> &hands,
+            int first_player);
+
   /**
    * @brief Get the index (0 or 1) of the player whose turn it is.
    */
@@ -4,19 +4,36 @@
 #include <arrow/result.h> //  (brings in ARROW_ASSIGN_OR_RAISE)
 #include <arrow/status.h>
 #include <arrow/table.h>
-#include <parquet/arrow/reader.h> //  ←  ADD THIS
-#include <parquet/arrow/writer.h>
 
+#include "async_table_writer.h"
+#include "event_log.h"
 #include "feature_extractor.h"
+#include "feature_pipeline.h"
+#include "game_archive.h"
 #include "game_coordinator.h"
 #include "game_record.h"
 #include "game_simulator.h"
+#include "game_stats.h"
+#include "ipc_table_writer.h"
+#include "jsonl_record_writer.h"
+#include "npy_sample_writer.h"
+#include "parquet_table_writer.h"
+#include "partitioned_dataset_writer.h"
+#include "perf_profiler.h"
 #include "player_factory.h"
+#include "thread_name.h"
+#include "trace_recorder.h"
+#include "training_sample_encoder.h"
 
+#include <algorithm>
 #include <atomic>
-#include <filesystem>
+#include <exception>
 #include <fstream>
 #include <iostream>
+#include <memory_resource>
+#include <omp.h>
+#include <optional>
+#include <stdexcept>
 #include <thread>
 
 GameCoordinator::GameCoordinator(
@@ -26,25 +43,155 @@ GameCoordinator::GameCoordinator(
     const std::string &log_path,
     std::vector<std::shared_ptr<FeatureExtractor>> game_level_features,
     std::vector<std::shared_ptr<FeatureExtractor>> turn_level_features)
+    : GameCoordinator(std::move(player_factory_p0),
+                      std::move(player_factory_p1), num_games, output_path,
+                      num_threads, random_seed, log_path,
+                      std::make_shared<ExtractorListPipeline>(
+                          FeatureExtractor::Type::GameLevel,
+                          std::move(game_level_features)),
+                      std::make_shared<ExtractorListPipeline>(
+                          FeatureExtractor::Type::TurnLevel,
+                          std::move(turn_level_features))) {}
+
+GameCoordinator::GameCoordinator(
+    std::shared_ptr<PlayerFactory> player_factory_p0,
+    std::shared_ptr<PlayerFactory> player_factory_p1, int num_games,
+    const std::string &output_path, int num_threads, unsigned int random_seed,
+    const std::string &log_path,
+    std::shared_ptr<FeaturePipeline> game_pipeline,
+    std::shared_ptr<FeaturePipeline> turn_pipeline)
     : _player_factory_p0(std::move(player_factory_p0)),
       _player_factory_p1(std::move(player_factory_p1)), _num_games(num_games),
       _output_path(output_path), _num_threads(std::max(1, num_threads)),
       _log_path(log_path), _rng_seed(random_seed),
-      _game_level_features(std::move(game_level_features)),
-      _turn_level_features(std::move(turn_level_features)) {}
+      _game_pipeline(std::move(game_pipeline)),
+      _turn_pipeline(std::move(turn_pipeline)) {}
 
 void GameCoordinator::run_all(const std::string &game_feature_out,
                               const std::string &turn_feature_out) {
 
-  constexpr int BATCH_SIZE = 200'000; // <= 200 k games per chunk
-  const std::string game_tmp_prefix = "tmp_game_batch_";
-  const std::string turn_tmp_prefix = "tmp_turn_batch_";
+  // Games per chunk. A whole batch of records and its feature tables are in
+  // memory at once, so this bounds peak memory
+  const int BATCH_SIZE = batch_games();
+
+  // One long-lived writer per output; each batch is appended as row groups
+  // as soon as it is extracted. Partitioned output instead gives every
+  // worker its own shard file, which the worker writes itself.
+  std::unique_ptr<TableWriter> game_writer;
+  std::unique_ptr<TableWriter> turn_writer;
+  std::unique_ptr<PartitionedDatasetWriter> game_dataset;
+  std::unique_ptr<PartitionedDatasetWriter> turn_dataset;
+  std::unique_ptr<NpySampleWriter> samples;
+  std::unique_ptr<JsonlRecordWriter> record_writer;
+  std::unique_ptr<EventLog> event_log;
+  std::unique_ptr<GameArchiveWriter> archive;
+  try {
+    // A stats-only run keeps no GameRecords, so nothing built from them
+    if (!_stats_only) {
+      if (_partitioned_output) {
+        if (has_features(_game_pipeline)) {
+          game_dataset = open_dataset(game_feature_out, *_game_pipeline);
+        }
+        if (has_features(_turn_pipeline)) {
+          turn_dataset = open_dataset(turn_feature_out, *_turn_pipeline);
+        }
+      } else {
+        if (has_features(_game_pipeline)) {
+          game_writer = open_writer(game_feature_out, *_game_pipeline);
+        }
+        if (has_features(_turn_pipeline)) {
+          turn_writer = open_writer(turn_feature_out, *_turn_pipeline);
+        }
+      }
+      if (!_npy_prefix.empty()) {
+        samples = std::make_unique<NpySampleWriter>(_npy_prefix);
+      }
+      if (!_output_path.empty()) {
+        record_writer = std::make_unique<JsonlRecordWriter>(_output_path);
+      }
+      if (!_archive_path.empty()) {
+        archive = std::make_unique<GameArchiveWriter>(_archive_path);
+      }
+    }
+    if (!_log_path.empty()) {
+      event_log = std::make_unique<EventLog>(_log_path, _num_threads,
+                                             _log_sample_every);
+    }
+  } catch (const std::exception &e) {
+    throw std::runtime_error(std::string("Error opening output files: ") +
+                             e.what());
+  }
+
+  ThreadName::set("coordinator");
+
+  // Timeline of all threads; spans anywhere in the process go to it while
+  // it is active
+  std::unique_ptr<TraceRecorder> trace;
+  if (!_trace_path.empty()) {
+    trace = std::make_unique<TraceRecorder>(_trace_path);
+    trace->activate();
+  }
+
+  // Hardware counters; regions anywhere in the process count into it
+  std::unique_ptr<PerfProfiler> profiler;
+  if (!_perf_path.empty()) {
+#ifdef BIG2_PERF_COUNTERS
+    profiler = std::make_unique<PerfProfiler>();
+    profiler->activate();
+#else
+    std::cerr << "Warning: built without PERF_COUNTERS=1, no performance "
+                 "counters are collected\n";
+#endif
+  }
+
+  // Record only the TurnRecord fields some output reads
+  _record_fields = RecordFields::kNone;
+  if (has_features(_game_pipeline))
+    _record_fields |= _game_pipeline->required_fields();
+  if (has_features(_turn_pipeline))
+    _record_fields |= _turn_pipeline->required_fields();
+  if (samples)
+    _record_fields |= TrainingSampleEncoder::kFields;
 
   int games_remaining = _num_games;
   int batch_idx = 0;
 
-  std::vector<std::string> tmp_game_files;
-  std::vector<std::string> tmp_turn_files;
+  // Per-thread arenas for the records' turn data. Nothing is freed during a
+  // batch; each arena hands all its memory back at once when the batch has
+  // been exported, and no allocation is shared between threads.
+  std::vector<std::pmr::monotonic_buffer_resource> arenas(_num_threads);
+
+  // Per-thread statistics, merged once every game has been played
+  const bool collect_stats = _stats_only || !_stats_path.empty();
+  std::vector<GameStats> thread_stats(collect_stats ? _num_threads : 0);
+
+  // Per-thread decision latencies, likewise merged at the end
+  const bool collect_latency = !_latency_path.empty();
+  const AgentLatency empty_latency(
+      {_player_factory_p0->name(), _player_factory_p1->name()});
+  std::vector<AgentLatency> thread_latency(
+      collect_latency ? _num_threads : 0, empty_latency);
+
+  // Throughput and phase timings; declared after the writers so that the
+  // reporter, which samples their queues, stops before they are destroyed
+  std::unique_ptr<RunMetrics> metrics;
+  if (!_metrics_path.empty() || _metrics_interval > 0.0) {
+    metrics = std::make_unique<RunMetrics>(_num_threads, _metrics_interval);
+    for (auto *writer : {game_writer.get(), turn_writer.get()}) {
+      if (auto *async = dynamic_cast<AsyncTableWriter *>(writer)) {
+        metrics->add_gauge(writer == game_writer.get() ? "game_write_queue"
+                                                       : "turn_write_queue",
+                           [async] { return double(async->pending()); });
+      }
+    }
+    if (event_log) {
+      EventLog *log = event_log.get();
+      metrics->add_gauge("log_queue", [log] { return double(log->pending()); });
+    }
+    metrics->start();
+  }
+  RunMetrics::Counters *main_metrics =
+      metrics ? &metrics->coordinator() : nullptr;
 
   while (games_remaining > 0) {
 
@@ -54,318 +201,400 @@ void GameCoordinator::run_all(const std::string &game_feature_out,
 
     // ------------------------------------------------------------------
     // simulate
+    TraceSpan batch_span("simulate_batch");
     std::atomic<int> next_index{0};
     std::vector<std::thread> workers;
     std::vector<std::vector<GameRecord>> local_batch(_num_threads);
+    std::vector<std::exception_ptr> shard_errors(_num_threads);
     workers.reserve(_num_threads);
 
     for (int t = 0; t < _num_threads; ++t) {
       workers.emplace_back([&, t]() {
+        ThreadName::set("worker " + std::to_string(t));
         std::mt19937 rng(_rng_seed + t + batch_idx * _num_threads);
         auto &out = local_batch[t];
+        std::optional<JsonlRecordWriter::Buffer> records;
+        if (record_writer)
+          records.emplace(*record_writer);
+        std::optional<GameArchiveWriter::Buffer> archived;
+        if (archive)
+          archived.emplace(*archive);
+        EventLog::Channel *channel =
+            event_log ? &event_log->channel(t) : nullptr;
+        ThreadHooks hooks;
+        if (collect_stats)
+          hooks.observer = &thread_stats[t];
+        if (metrics)
+          hooks.metrics = &metrics->thread(t);
+        if (collect_latency)
+          hooks.latency = &thread_latency[t];
+        RunMetrics::Counters *counters = hooks.metrics;
         int idx;
         while ((idx = next_index.fetch_add(1)) < this_batch) {
-          out.emplace_back(simulate_single_game(rng));
+          const uint64_t game_id =
+              static_cast<uint64_t>(batch_idx) * BATCH_SIZE + idx;
+          TraceSpan span("simulate_game");
+          if (_stats_only) {
+            play_single_game(rng, channel, game_id, hooks);
+            continue;
+          }
+          out.emplace_back(
+              simulate_single_game(rng, channel, game_id, &arenas[t], hooks));
+          span.end();
+          TraceSpan write_span("write_game");
+          try {
+            if (records)
+              records->append(out.back());
+            if (archived)
+              archived->append(game_id, out.back());
+            if (samples)
+              samples->write(out.back());
+          } catch (const std::exception &e) {
+            std::cerr << "Error writing game output: " << e.what()
+                      << std::endl;
+          }
+        }
+        TraceSpan flush_span("flush_records");
+        try {
+          if (records)
+            records->flush();
+          if (archived)
+            archived->flush();
+        } catch (const std::exception &e) {
+          std::cerr << "Error writing game records: " << e.what() << std::endl;
+        }
+        flush_span.end();
+
+        // Partitioned output: this worker owns shard t of each dataset
+        TraceSpan shard_span("write_shard");
+        try {
+          if (game_dataset) {
+            auto table = _game_pipeline->build_table(out, 1, counters);
+            RunMetrics::ScopedTimer timer(counters, RunMetrics::kWrite);
+            game_dataset->write(t, *table);
+          }
+          if (turn_dataset) {
+            auto table = _turn_pipeline->build_table(out, 1, counters);
+            RunMetrics::ScopedTimer timer(counters, RunMetrics::kWrite);
+            turn_dataset->write(t, *table);
+          }
+        } catch (...) {
+          shard_errors[t] = std::current_exception();
         }
       });
     }
     for (auto &th : workers)
       if (th.joinable())
         th.join();
+    batch_span.end();
+    // A missing shard would otherwise still be counted in the manifest
+    for (int t = 0; t < _num_threads; ++t) {
+      if (!shard_errors[t])
+        continue;
+      try {
+        std::rethrow_exception(shard_errors[t]);
+      } catch (const std::exception &e) {
+        throw std::runtime_error("Error writing shard " + std::to_string(t) +
+                                 ": " + e.what());
+      }
+    }
 
-    // flatten into _records (re‑use member to leverage existing exporters)
-    _records.clear();
-    for (auto &vec : local_batch)
-      _records.insert(_records.end(), vec.begin(), vec.end());
-
-    // ------------------------------------------------------------------ export
-    // batch
-    std::string gfile =
-        game_tmp_prefix + std::to_string(batch_idx) + ".parquet";
-    std::string tfile =
-        turn_tmp_prefix + std::to_string(batch_idx) + ".parquet";
-    export_features(gfile, tfile);
-    tmp_game_files.push_back(gfile);
-    tmp_turn_files.push_back(tfile);
-
-    // free memory before next batch
+    if (!_partitioned_output && !_stats_only) {
+      // flatten into _records (re‑use member to leverage existing exporters)
+      // in game-id order, so output rows line up with big2-extract's.
+      // Move construction keeps each record's data in its arena.
+      TraceSpan flatten_span("flatten");
+      const uint64_t first_id = static_cast<uint64_t>(batch_idx) * BATCH_SIZE;
+      std::vector<GameRecord *> by_id(this_batch);
+      for (auto &vec : local_batch)
+        for (auto &record : vec)
+          by_id[record.game_id() - first_id] = &record;
+      _records.clear();
+      _records.reserve(this_batch);
+      for (GameRecord *record : by_id)
+        _records.push_back(std::move(*record));
+      flatten_span.end();
+
+      // -------------------------------------------------------------- append
+      // batch to the open writers
+      if (game_writer)
+        export_game_features(*game_writer, main_metrics);
+      if (turn_writer)
+        export_turn_features(*turn_writer, main_metrics);
+    }
+
+    // free memory before next batch; the records' turn data goes back with
+    // the arenas in one step
+    TraceSpan free_span("free_batch");
     _records.clear();
     local_batch.clear();
     workers.clear();
+    for (auto &arena : arenas)
+      arena.release();
 
     games_remaining -= this_batch;
     ++batch_idx;
   }
 
-  // ------------------------------------------------------------------
-  // concatenate helper
-  auto concat = [](const std::vector<std::string> &parts,
-                   const std::string &out_file) {
-    std::shared_ptr<arrow::Table> concat_table;
-
-    for (size_t i = 0; i < parts.size(); ++i) {
-
-      // Open Parquet file and read full table
-      ARROW_ASSIGN_OR_RAISE(auto rf, arrow::io::ReadableFile::Open(parts[i]));
-
-      std::unique_ptr<parquet::arrow::FileReader> reader;
-      PARQUET_THROW_NOT_OK(
-          parquet::arrow::OpenFile(rf, arrow::default_memory_pool(), &reader));
-
-      std::shared_ptr<arrow::Table> piece;
-      PARQUET_THROW_NOT_OK(reader->ReadTable(&piece));
-
-      // Append to running table
-      if (i == 0) {
-        concat_table = piece;
-      } else {
-        ARROW_ASSIGN_OR_RAISE(
-            concat_table,
-            arrow::ConcatenateTables({concat_table, piece},
-                                     arrow::ConcatenateTablesOptions{false}));
+  // ------------------------------------------------------------------ write
+  // footers
+  try {
+    {
+      // Closing drains the pipelined writers, so it counts as writing
+      RunMetrics::ScopedTimer timer(main_metrics, RunMetrics::kWrite);
+      TraceSpan span("close_writers");
+      if (game_writer)
+        game_writer->close();
+      if (turn_writer)
+        turn_writer->close();
+    }
+    if (game_dataset)
+      game_dataset->close();
+    if (turn_dataset)
+      turn_dataset->close();
+    if (event_log)
+      event_log->close();
+    if (record_writer) {
+      record_writer->close();
+      std::cout << "[Coordinator] Wrote "
+                << record_writer->bytes_written() / 1e6
+                << " MB of game records to " << _output_path << "\n";
+    }
+    if (archive) {
+      archive->close();
+      std::cout << "[Coordinator] Archived " << archive->num_games()
+                << " games (" << archive->bytes_written() / 1e6 << " MB) to "
+                << _archive_path << "\n";
+    }
+    if (samples) {
+      samples->close();
+      std::cout << "[Coordinator] Wrote " << samples->num_samples()
+                << " training samples to " << _npy_prefix << "*.npy\n";
+    }
+    if (collect_stats) {
+      _stats = GameStats();
+      for (const auto &stats : thread_stats)
+        _stats.merge(stats);
+      _stats.print(std::cout);
+      if (!_stats_path.empty()) {
+        std::ofstream out(_stats_path);
+        _stats.write_json(out);
+        if (!out)
+          throw std::runtime_error("Could not write " + _stats_path);
       }
     }
-
-    // Write final table
-    ARROW_ASSIGN_OR_RAISE(auto out,
-                          arrow::io::FileOutputStream::Open(out_file));
-
-    PARQUET_THROW_NOT_OK(parquet::arrow::WriteTable(
-        *concat_table, arrow::default_memory_pool(), out, 4096));
-  };
-
-  std::cout << "[Coordinator] Concatenating " << tmp_game_files.size()
-            << " game batches...\n";
-  concat(tmp_game_files, game_feature_out);
-
-  std::cout << "[Coordinator] Concatenating " << tmp_turn_files.size()
-            << " turn batches...\n";
-  concat(tmp_turn_files, turn_feature_out);
-
-  // ------------------------------------------------------------------ clean up
-  // temp files
-  for (auto &f : tmp_game_files)
-    std::filesystem::remove(f);
-  for (auto &f : tmp_turn_files)
-    std::filesystem::remove(f);
+    if (collect_latency) {
+      _latency = empty_latency;
+      for (const auto &latency : thread_latency)
+        _latency.merge(latency);
+      _latency.print(std::cout);
+      std::ofstream out(_latency_path);
+      _latency.write_json(out);
+      if (!out)
+        throw std::runtime_error("Could not write " + _latency_path);
+    }
+    if (metrics) {
+      metrics->stop();
+      _totals = metrics->totals();
+      metrics->print(std::cout);
+      if (!_metrics_path.empty()) {
+        std::ofstream out(_metrics_path);
+        metrics->write_json(out);
+        if (!out)
+          throw std::runtime_error("Could not write " + _metrics_path);
+      }
+    }
+    if (profiler) {
+      profiler->close();
+      profiler->print(std::cout);
+      std::ofstream out(_perf_path);
+      profiler->write_json(out);
+      if (!out)
+        throw std::runtime_error("Could not write " + _perf_path);
+    }
+    if (trace) {
+      trace->close();
+      std::cout << "[Coordinator] Wrote trace to " << _trace_path << "\n";
+    }
+  } catch (const std::exception &e) {
+    throw std::runtime_error(std::string("Error finalizing output files: ") +
+                             e.what());
+  }
 
   std::cout
-      << "[Coordinator] All batches complete — final Parquet files written.\n";
+      << "[Coordinator] All batches complete — final output files written.\n";
 }
 
-GameRecord GameCoordinator::simulate_single_game(std::mt19937 &rng) {
+GameRecord GameCoordinator::simulate_single_game(
+    std::mt19937 &rng, EventLog::Channel *log, uint64_t game_id,
+    std::pmr::memory_resource *arena, const ThreadHooks &hooks) {
   auto player0 = _player_factory_p0->create_player();
   auto player1 = _player_factory_p1->create_player();
-  GameSimulator sim(std::move(player0), std::move(player1), rng, _log_path);
+  GameSimulator sim(std::move(player0), std::move(player1), rng, log,
+                    game_id, _record_fields, arena);
+  attach_hooks(sim, hooks);
   return sim.run();
 }
 
+void GameCoordinator::play_single_game(std::mt19937 &rng,
+                                       EventLog::Channel *log,
+                                       uint64_t game_id,
+                                       const ThreadHooks &hooks) {
+  auto player0 = _player_factory_p0->create_player();
+  auto player1 = _player_factory_p1->create_player();
+  GameSimulator sim(std::move(player0), std::move(player1), rng, log,
+                    game_id, RecordFields::kNone);
+  attach_hooks(sim, hooks);
+  sim.play();
+}
+
+void GameCoordinator::attach_hooks(GameSimulator &sim,
+                                   const ThreadHooks &hooks) {
+  sim.set_observer(hooks.observer);
+  sim.set_metrics(hooks.metrics);
+  sim.set_latency(hooks.latency);
+}
+
 // --------------------------------------------------------
 // Feature Extraction: Arrow table output
 // --------------------------------------------------------
 void GameCoordinator::export_features(
     const std::string &game_feature_out,
     const std::string &turn_feature_out) const {
-  export_game_features(game_feature_out);
-  export_turn_features(turn_feature_out);
-}
-
-void GameCoordinator::export_game_features(const std::string &out_file) const {
-  if (_game_level_features.empty()) {
-    std::cout << "No game-level features to export.\n";
-    return;
+  if (has_features(_game_pipeline)) {
+    auto writer = open_writer(game_feature_out, *_game_pipeline);
+    export_game_features(*writer);
+    writer->close();
   }
-
-  if (_records.empty()) {
-    std::cout << "No game records to export.\n";
-    return;
+  if (has_features(_turn_pipeline)) {
+    auto writer = open_writer(turn_feature_out, *_turn_pipeline);
+    export_turn_features(*writer);
+    writer->close();
   }
+}
 
-  std::cout << "Exporting " << _records.size() << " game records with "
-            << _game_level_features.size() << " features...\n";
-
-  try {
-    // Each feature is a column (vector<int>)
-    std::vector<std::shared_ptr<arrow::Array>> columns;
-    std::vector<std::shared_ptr<arrow::Field>> schema_fields;
-
-    for (const auto &extractor : _game_level_features) {
-      if (!extractor) {
-        std::cerr << "Warning: Null feature extractor found, skipping.\n";
-        continue;
-      }
-
-      arrow::Int32Builder builder;
-      for (const auto &record : _records) {
-        int feature_value = extractor->gameExtract(record);
-        auto status = builder.Append(feature_value);
-        if (!status.ok()) {
-          std::cerr << "Error appending to builder: " << status.ToString()
-                    << std::endl;
-          return;
-        }
-      }
-
-      std::shared_ptr<arrow::Array> arr;
-      auto status = builder.Finish(&arr);
-      if (!status.ok()) {
-        std::cerr << "Error finishing builder: " << status.ToString()
-                  << std::endl;
-        return;
-      }
-
-      columns.push_back(arr);
-      schema_fields.push_back(arrow::field(extractor->name(), arrow::int32()));
-    }
-
-    if (columns.empty()) {
-      std::cout << "No valid features to export.\n";
-      return;
-    }
+int GameCoordinator::batch_games() const {
+  if (_batch_games > 0) {
+    return _batch_games;
+  }
+  // About one turn-level row group per batch: two rows (one per
+  // perspective) per turn, and greedy games average about 16 turns
+  constexpr int64_t kTurnRowsPerGame = 32;
+  return static_cast<int>(std::clamp<int64_t>(
+      _parquet_config.row_group_size / kTurnRowsPerGame, 1'000, 200'000));
+}
 
-    auto schema = std::make_shared<arrow::Schema>(schema_fields);
-    auto table = arrow::Table::Make(schema, columns, _records.size());
+bool GameCoordinator::has_features(
+    const std::shared_ptr<FeaturePipeline> &pipeline) {
+  return pipeline && pipeline->num_columns() > 0;
+}
 
-    // Write to Parquet file
-    auto file_result = arrow::io::FileOutputStream::Open(out_file);
-    if (!file_result.ok()) {
-      std::cerr << "Error opening output file: "
-                << file_result.status().ToString() << std::endl;
-      return;
-    }
-    auto outfile = file_result.ValueOrDie();
-
-    auto write_status = parquet::arrow::WriteTable(
-        *table, arrow::default_memory_pool(), outfile, 4096);
-    if (!write_status.ok()) {
-      std::cerr << "Error writing Parquet file: " << write_status.ToString()
-                << std::endl;
-      return;
+std::unique_ptr<TableWriter>
+GameCoordinator::open_writer(const std::string &path,
+                             const FeaturePipeline &pipeline) const {
+  if (_shuffle_config.enabled) {
+    auto shuffler = std::make_unique<ShuffledShardWriter>(
+        path, pipeline.schema(), pipeline.columns(), _shuffle_config,
+        [&](const std::string &shard) {
+          return open_file_writer(shard, pipeline);
+        });
+    // Mixing and cutting shards runs on its own thread, overlapped with
+    // simulating the next batch; each shard is then encoded on another
+    if (_parquet_config.pipelined) {
+      return std::make_unique<AsyncTableWriter>(std::move(shuffler));
     }
+    return shuffler;
+  }
+  return open_file_writer(path, pipeline);
+}
 
-    std::cout << "Successfully exported game features to: " << out_file
-              << std::endl;
+std::unique_ptr<TableWriter>
+GameCoordinator::open_file_writer(const std::string &path,
+                                  const FeaturePipeline &pipeline) const {
+  switch (_output_format) {
+  case OutputFormat::kArrowIpc:
+    return IpcTableWriter::OpenFile(path, pipeline.schema());
+  case OutputFormat::kSharedMemory:
+    return IpcTableWriter::OpenSharedMemory(path, pipeline.schema());
+  case OutputFormat::kParquet:
+    break;
+  }
+  auto writer = std::make_unique<ParquetTableWriter>(
+      path, pipeline.schema(), _parquet_config, pipeline.columns());
+  if (_parquet_config.pipelined) {
+    return std::make_unique<AsyncTableWriter>(std::move(writer));
+  }
+  return writer;
+}
 
-  } catch (const std::exception &e) {
-    std::cerr << "Exception in export_game_features: " << e.what() << std::endl;
+std::unique_ptr<PartitionedDatasetWriter>
+GameCoordinator::open_dataset(const std::string &root,
+                              const FeaturePipeline &pipeline) const {
+  std::string extension;
+  switch (_output_format) {
+  case OutputFormat::kParquet:
+    extension = "parquet";
+    break;
+  case OutputFormat::kArrowIpc:
+    extension = "arrow";
+    break;
+  case OutputFormat::kSharedMemory:
+    throw std::invalid_argument(
+        "Partitioned output needs a file format, not shared memory.");
   }
+  return std::make_unique<PartitionedDatasetWriter>(
+      root, _rng_seed, _num_threads, pipeline.schema(), extension,
+      [&](const std::string &path) {
+        return open_file_writer(path, pipeline);
+      });
 }
 
-void GameCoordinator::export_turn_features(const std::string &out_file) const {
-  if (_turn_level_features.empty()) {
-    std::cout << "No turn-level features to export.\n";
+void GameCoordinator::export_game_features(
+    TableWriter &writer, RunMetrics::Counters *metrics) const {
+  if (_records.empty()) {
+    std::cout << "No game records to export.\n";
     return;
   }
 
+  std::cout << "Exporting " << _records.size() << " game records with "
+            << _game_pipeline->num_columns() << " features...\n";
+
+  // Errors propagate: a batch missing from the output must fail the run
+  auto table = _game_pipeline->build_table(_records, _num_threads, metrics);
+  {
+    RunMetrics::ScopedTimer timer(metrics, RunMetrics::kWrite);
+    TraceSpan span("write");
+    writer.write(*table);
+  }
+
+  std::cout << "Successfully exported game features." << std::endl;
+}
+
+void GameCoordinator::export_turn_features(
+    TableWriter &writer, RunMetrics::Counters *metrics) const {
   if (_records.empty()) {
     std::cout << "No game records to export.\n";
     return;
   }
 
   std::cout << "Exporting turn features for " << _records.size()
-            << " games with " << _turn_level_features.size()
+            << " games with " << _turn_pipeline->num_columns()
             << " features...\n";
 
-  try {
-    // Flatten all turns in all games for all features
-    // All columns will have same number of entries: total_turns
-    std::vector<std::vector<int>> all_columns(_turn_level_features.size());
-    size_t total_turns = 0;
-
-    for (size_t f = 0; f < _turn_level_features.size(); ++f) {
-      if (!_turn_level_features[f]) {
-        std::cerr << "Warning: Null turn feature extractor at index " << f
-                  << ", skipping.\n";
-        continue;
-      }
-
-      for (const auto &record : _records) {
-        auto feature_vals = _turn_level_features[f]->turnExtract(record);
-        all_columns[f].insert(all_columns[f].end(), feature_vals.begin(),
-                              feature_vals.end());
-      }
-    }
-
-    if (!all_columns.empty()) {
-      total_turns = all_columns[0].size();
-    }
-
-    if (total_turns == 0) {
-      std::cout << "No turns found to export.\n";
-      return;
-    }
-
-    // Verify all columns have the same size
-    for (size_t f = 0; f < all_columns.size(); ++f) {
-      if (all_columns[f].size() != total_turns) {
-        std::cerr << "Error: Feature column " << f << " has size "
-                  << all_columns[f].size() << " but expected " << total_turns
-                  << std::endl;
-        return;
-      }
-    }
-
-    std::cout << "Processing " << total_turns << " total turns...\n";
-
-    // Build Arrow columns
-    std::vector<std::shared_ptr<arrow::Array>> columns;
-    std::vector<std::shared_ptr<arrow::Field>> schema_fields;
-
-    for (size_t f = 0; f < _turn_level_features.size(); ++f) {
-      if (!_turn_level_features[f])
-        continue; // Skip null extractors
+  auto table = _turn_pipeline->build_table(_records, _num_threads, metrics);
 
-      arrow::Int32Builder builder;
-      for (auto v : all_columns[f]) {
-        auto status = builder.Append(v);
-        if (!status.ok()) {
-          std::cerr << "Error appending to turn builder: " << status.ToString()
-                    << std::endl;
-          return;
-        }
-      }
-
-      std::shared_ptr<arrow::Array> arr;
-      auto status = builder.Finish(&arr);
-      if (!status.ok()) {
-        std::cerr << "Error finishing turn builder: " << status.ToString()
-                  << std::endl;
-        return;
-      }
-
-      columns.push_back(arr);
-      schema_fields.push_back(
-          arrow::field(_turn_level_features[f]->name(), arrow::int32()));
-    }
-
-    if (columns.empty()) {
-      std::cout << "No valid turn features to export.\n";
-      return;
-    }
-
-    auto schema = std::make_shared<arrow::Schema>(schema_fields);
-    auto table = arrow::Table::Make(schema, columns, total_turns);
-
-    auto file_result = arrow::io::FileOutputStream::Open(out_file);
-    if (!file_result.ok()) {
-      std::cerr << "Error opening turn output file: "
-                << file_result.status().ToString() << std::endl;
-      return;
-    }
-    auto outfile = file_result.ValueOrDie();
-
-    auto write_status = parquet::arrow::WriteTable(
-        *table, arrow::default_memory_pool(), outfile, 4096);
-    if (!write_status.ok()) {
-      std::cerr << "Error writing turn Parquet file: "
-                << write_status.ToString() << std::endl;
-      return;
-    }
+  if (table->num_rows() == 0) {
+    std::cout << "No turns found to export.\n";
+    return;
+  }
 
-    std::cout << "Successfully exported turn features to: " << out_file
-              << std::endl;
+  std::cout << "Processing " << table->num_rows() << " total turns...\n";
 
-  } catch (const std::exception &e) {
-    std::cerr << "Exception in export_turn_features: " << e.what() << std::endl;
+  {
+    RunMetrics::ScopedTimer timer(metrics, RunMetrics::kWrite);
+    TraceSpan span("write");
+    writer.write(*table);
   }
-}
\ No newline at end of file
+
+  std::cout << "Successfully exported turn features." << std::endl;
+}
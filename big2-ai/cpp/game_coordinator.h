@@ -2,27 +2,51 @@
 #ifndef GAME_COORDINATOR_H
 #define GAME_COORDINATOR_H
 
+#include <algorithm>
 #include <arrow/api.h> // Apache Arrow C++ headers
 #include <memory>
+#include <memory_resource>
 #include <random>
 #include <string>
 #include <vector>
 
+#include "agent_latency.h"
+#include "event_log.h"
+#include "game_record.h"
+#include "game_stats.h"
+#include "parquet_writer_config.h"
+#include "run_metrics.h"
+#include "shuffled_shard_writer.h"
+
 class PlayerFactory;
 class GameSimulator;
 struct GameRecord;
 class FeatureExtractor; // <-- forward declared
+class FeaturePipeline;
+class TableWriter;
+class PartitionedDatasetWriter;
 
 class GameCoordinator {
 public:
+  /**
+   * @brief File format of the feature outputs.
+   * kArrowIpc writes Arrow IPC (Feather v2) files; kSharedMemory writes the
+   * same format into POSIX shared-memory segments named by the output paths
+   * (e.g. "/big2_turn_features") for zero-copy reads from Python.
+   */
+  enum class OutputFormat { kParquet, kArrowIpc, kSharedMemory };
+
   /**
    * @brief Construct a new GameCoordinator.
    * @param player_factory_p0 Factory for Player 0 (first player) Agents.
    * @param player_factory_p1 Factory for Player 1 (second player) Agents.
    * @param num_games Number of self-play games to simulate.
-   * @param output_path Path to write the collected GameRecord data.
+   * @param output_path JSON Lines file for the game records (deal, moves,
+   *                    winner); empty disables.
    * @param num_threads Number of concurrent threads to use.
    * @param random_seed Optional RNG seed (default: random_device).
+   * @param log_path Prefix of the binary event log files
+   *                 (`<log_path>_thread<k>.b2log`); empty disables.
    */
   GameCoordinator(
       std::shared_ptr<PlayerFactory> player_factory_p0,
@@ -34,11 +58,148 @@ public:
       std::vector<std::shared_ptr<FeatureExtractor>> turn_level_features = {});
 
   /**
-   * @brief Run all self-play games
+   * @brief Construct with prebuilt feature pipelines, e.g. a compile-time
+   * FeatureSet. Either pipeline may be null.
+   */
+  GameCoordinator(std::shared_ptr<PlayerFactory> player_factory_p0,
+                  std::shared_ptr<PlayerFactory> player_factory_p1,
+                  int num_games, const std::string &output_path,
+                  int num_threads, unsigned int random_seed,
+                  const std::string &log_path,
+                  std::shared_ptr<FeaturePipeline> game_pipeline,
+                  std::shared_ptr<FeaturePipeline> turn_pipeline);
+
+  /**
+   * @brief Run all self-play games, streaming each batch's features into the
+   * output Parquet files as it completes.
+   * @throws std::runtime_error if an output cannot be opened, written or
+   *         finalized; the run stops and the affected files are left
+   *         without a footer.
    */
   void run_all(const std::string &game_feature_out,
                const std::string &turn_feature_out);
 
+  /**
+   * @brief Codec, encodings, statistics and row-group size for Parquet output.
+   */
+  void set_parquet_config(const ParquetWriterConfig &config) {
+    _parquet_config = config;
+  }
+
+  void set_output_format(OutputFormat format) { _output_format = format; }
+
+  /**
+   * @brief Games simulated and exported per batch. A batch's records and
+   * feature tables are held in memory together, so this bounds peak memory.
+   * 0 (the default) sizes batches to about one turn-level Parquet row group.
+   */
+  void set_batch_size(int games) { _batch_games = std::max(0, games); }
+
+  /**
+   * @brief Write Hive-partitioned datasets instead of single files.
+   * run_all()'s output paths then name dataset directories laid out as
+   * run=<seed>/shard=<worker>/part-0.<ext>, one stream per worker thread.
+   * A seed whose run directory already exists is refused, not overwritten.
+   */
+  void set_partitioned_output(bool enabled) { _partitioned_output = enabled; }
+
+  /**
+   * @brief Pass feature outputs through a seeded shuffle buffer and write
+   * them as fixed-size shards `<stem>-00000<ext>`, `<stem>-00001<ext>`, ...
+   * With ParquetWriterConfig::pipelined (the default) the shuffle runs on a
+   * background thread. Not used together with partitioned output.
+   */
+  void set_shuffle_config(const ShuffleConfig &config) {
+    _shuffle_config = config;
+  }
+
+  /**
+   * @brief Log only every n-th game (by game id) to the binary event log
+   * at log_path. Defaults to every game.
+   */
+  void set_log_sampling(uint64_t every_n) { _log_sample_every = every_n; }
+
+  /**
+   * @brief Also stream training tensors (state, legal mask, value, move) to
+   * `<prefix>*_samples.npy` as games finish. Empty disables.
+   */
+  void set_npy_output(const std::string &prefix) { _npy_prefix = prefix; }
+
+  /**
+   * @brief Also keep every game in a compact binary archive indexed by game
+   * id (see GameArchiveReader). Empty disables.
+   */
+  void set_archive_output(const std::string &path) { _archive_path = path; }
+
+  /**
+   * @brief Aggregate win rate, game lengths, pass rate and combination use
+   * over all games with per-thread observers, print a summary and write it
+   * as JSON to `path`. Empty disables (unless stats-only).
+   */
+  void set_stats_output(const std::string &path) { _stats_path = path; }
+
+  /**
+   * @brief Collect statistics only: no GameRecords are kept and the feature,
+   * record, archive and sample outputs are skipped, so memory use stays
+   * constant however many games are played.
+   */
+  void set_stats_only(bool enabled) { _stats_only = enabled; }
+
+  /**
+   * @brief Count games and turns per thread and time move selection, move
+   * application, recording, feature extraction, Arrow assembly and writing;
+   * write the totals, peak RSS and writer queue depths as JSON to `path`.
+   * Empty disables (unless progress reports are on).
+   */
+  void set_metrics_output(const std::string &path) { _metrics_path = path; }
+
+  /**
+   * @brief Print throughput, RSS and queue depths every `seconds` during
+   * run_all(). 0 (the default) disables.
+   */
+  void set_metrics_interval(double seconds) { _metrics_interval = seconds; }
+
+  /**
+   * @brief Time every move decision per agent (seat) and legal move count,
+   * print p50 / p99 / max latency and each agent's share of decision time,
+   * and write the full breakdown as JSON to `path`. Empty disables.
+   */
+  void set_latency_output(const std::string &path) { _latency_path = path; }
+
+  /**
+   * @brief Record a timeline of every thread's work (games, extraction,
+   * column building, row-group writes, queue waits) and write it to `path`
+   * as Chrome trace JSON for chrome://tracing or Perfetto. Empty disables.
+   */
+  void set_trace_output(const std::string &path) { _trace_path = path; }
+
+  /**
+   * @brief Count cycles, instructions, cache and branch misses per thread
+   * around the hot functions (move generation, select_move, recording,
+   * extraction), print them per game and per turn and write them as JSON
+   * to `path`. Needs a build with PERF_COUNTERS=1. Empty disables.
+   */
+  void set_perf_output(const std::string &path) { _perf_path = path; }
+
+  /**
+   * @brief Statistics of the last run_all() that collected them.
+   */
+  const GameStats &stats() const { return _stats; }
+
+  /**
+   * @brief Decision latencies of the last run_all() that collected them.
+   */
+  const AgentLatency &latency() const { return _latency; }
+
+  /**
+   * @brief Throughput of the last run_all() that collected metrics.
+   */
+  const RunMetrics::Totals &totals() const { return _totals; }
+
+  /**
+   * @brief Write features of the records currently held to new files.
+   * Write errors are rethrown.
+   */
   void export_features(const std::string &game_feature_out,
                        const std::string &turn_feature_out) const;
 
@@ -49,25 +210,80 @@ private:
   std::string _output_path;
   int _num_threads;
   std::string _log_path;
+  uint64_t _log_sample_every = 1;
   unsigned int _rng_seed;
 
-  // Feature extractor lists
-  std::vector<std::shared_ptr<FeatureExtractor>> _game_level_features;
-  std::vector<std::shared_ptr<FeatureExtractor>> _turn_level_features;
+  // Feature pipelines (game-level and turn-level)
+  std::shared_ptr<FeaturePipeline> _game_pipeline;
+  std::shared_ptr<FeaturePipeline> _turn_pipeline;
+
+  OutputFormat _output_format = OutputFormat::kParquet;
+  int _batch_games = 0;
+  bool _partitioned_output = false;
+  std::string _npy_prefix;
+  std::string _archive_path;
+  std::string _stats_path;
+  bool _stats_only = false;
+  GameStats _stats;
+  std::string _metrics_path;
+  double _metrics_interval = 0.0;
+  RunMetrics::Totals _totals;
+  std::string _latency_path;
+  std::string _trace_path;
+  std::string _perf_path;
+  AgentLatency _latency;
+  ParquetWriterConfig _parquet_config;
+  ShuffleConfig _shuffle_config;
+
+  // TurnRecord fields the enabled outputs read; set by run_all()
+  uint32_t _record_fields = RecordFields::kAll;
 
   // Store all game records here (1 per game)
   std::vector<GameRecord> _records;
 
+  // Per-thread instrumentation attached to every game a worker plays; null
+  // members are disabled
+  struct ThreadHooks {
+    GameObserver *observer = nullptr;
+    RunMetrics::Counters *metrics = nullptr;
+    AgentLatency *latency = nullptr;
+  };
+
   /**
    * @brief Simulate a single game using GameSimulator and RNG.
    * @param rng A thread-local random number generator.
+   * @param log Event log channel of the calling thread, or nullptr.
+   * @param game_id Run-wide game index, used as the log's game id.
+   * @param arena Allocator of the record's turn data.
+   * @param hooks Instrumentation of the calling thread.
    * @return The GameRecord for one completed game.
    */
-  GameRecord simulate_single_game(std::mt19937 &rng);
+  GameRecord simulate_single_game(std::mt19937 &rng, EventLog::Channel *log,
+                                  uint64_t game_id,
+                                  std::pmr::memory_resource *arena,
+                                  const ThreadHooks &hooks);
+
+  /**
+   * @brief Play one game for its hooks and log only; nothing is recorded.
+   */
+  void play_single_game(std::mt19937 &rng, EventLog::Channel *log,
+                        uint64_t game_id, const ThreadHooks &hooks);
 
   // Helpers
-  void export_game_features(const std::string &out_file) const;
-  void export_turn_features(const std::string &out_file) const;
+  static void attach_hooks(GameSimulator &sim, const ThreadHooks &hooks);
+  int batch_games() const;
+  static bool has_features(const std::shared_ptr<FeaturePipeline> &pipeline);
+  std::unique_ptr<TableWriter>
+  open_writer(const std::string &path, const FeaturePipeline &pipeline) const;
+  std::unique_ptr<TableWriter>
+  open_file_writer(const std::string &path,
+                   const FeaturePipeline &pipeline) const;
+  std::unique_ptr<PartitionedDatasetWriter>
+  open_dataset(const std::string &root, const FeaturePipeline &pipeline) const;
+  void export_game_features(TableWriter &writer,
+                            RunMetrics::Counters *metrics = nullptr) const;
+  void export_turn_features(TableWriter &writer,
+                            RunMetrics::Counters *metrics = nullptr) const;
 };
 
 #endif // GAME_COORDINATOR_H
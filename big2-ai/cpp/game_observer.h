@@ -0,0 +1,42 @@
+// game_observer.h
+#ifndef GAME_OBSERVER_H
+#define GAME_OBSERVER_H
+
+#include "game.h"
+#include "move.h"
+
+/**
+ * @brief Callbacks from GameSimulator as a game is played.
+ *
+ * Observers see every game whether or not a GameRecord is kept, so they can
+ * aggregate statistics in constant memory. A simulator without an observer
+ * pays one predictable branch per turn.
+ */
+class GameObserver {
+public:
+  virtual ~GameObserver() = default;
+
+  /**
+   * @brief Cards have been dealt; `game` is the state before the first move.
+   */
+  virtual void on_deal(const Game &game) { (void)game; }
+
+  /**
+   * @brief `player` played `move`; `after` is the state once it is applied.
+   */
+  virtual void on_move(int player, const Move &move, const Game &after) {
+    (void)player;
+    (void)move;
+    (void)after;
+  }
+
+  /**
+   * @brief The game is over after `num_turns` moves.
+   */
+  virtual void on_game_end(const Game &game, int num_turns) {
+    (void)game;
+    (void)num_turns;
+  }
+};
+
+#endif // GAME_OBSERVER_H
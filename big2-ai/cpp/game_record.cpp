@@ -1,28 +1,54 @@
 // game_record.cpp
 #include "game_record.h"
 #include "game.h"
+#include "perf_profiler.h"
 #include <arrow/api.h>
 #include <sstream>
 
-GameRecord::GameRecord() {}
+// Fields computed from the players' views
+static constexpr uint32_t kViewFields = RecordFields::kViews |
+                                        RecordFields::kLegalMoves |
+                                        RecordFields::kPossibleMoves;
+
+// Most games end within this many turns; reserving them up front avoids
+// regrowing the turn list, which an arena cannot reclaim
+static constexpr size_t kReservedTurns = 32;
+
+GameRecord::GameRecord(uint32_t fields, std::pmr::memory_resource *resource)
+    : _fields(fields), _turns(resource) {}
 
 void GameRecord::set_initial_state(const Game &game) {
+  _turns.reserve(kReservedTurns);
+  _initial_game = game;
   _game = game;
-  _views[0] = PartialGame(game, 0);
-  _views[1] = PartialGame(game, 1);
+  if (_fields & kViewFields) {
+    _views[0] = PartialGame(game, 0);
+    _views[1] = PartialGame(game, 1);
+  }
 }
 
 void GameRecord::add_move(const Move &move) {
+  BIG2_PERF_REGION(kAddMove);
+  const int player = _game.current_player();
+  auto *resource = _turns.get_allocator().resource();
   TurnRecord new_record{
-      /* current_player  */ _game.current_player(),
-      /* game           */ _game,
-      /* views          */ _views,
-      /* legal_moves    */ _views[_game.current_player()].get_legal_moves(),
-      /* possible_moves */
-      _views[1 - _game.current_player()].get_possible_moves(),
+      /* current_player  */ player,
+      /* game           */
+      (_fields & RecordFields::kGame) ? _game : Game(),
+      /* views          */
+      (_fields & RecordFields::kViews) ? _views
+                                       : std::array<PartialGame, 2>{},
+      /* legal_moves    */ std::pmr::vector<int>(resource),
+      /* possible_moves */ std::pmr::vector<int>(resource),
       /* move           */ move};
-  _turns.push_back(new_record);
+  if (_fields & RecordFields::kLegalMoves)
+    _views[player].get_legal_moves(new_record.legal_moves);
+  if (_fields & RecordFields::kPossibleMoves)
+    _views[1 - player].get_possible_moves(new_record.possible_moves);
+  _turns.push_back(std::move(new_record));
   _game.apply_move(move);
-  _views[0].apply_move(move);
-  _views[1].apply_move(move);
+  if (_fields & kViewFields) {
+    _views[0].apply_move(move);
+    _views[1].apply_move(move);
+  }
 }
@@ -3,7 +3,9 @@
 #define GAME_RECORD_H
 
 #include <array>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -15,15 +17,31 @@
 // Forward declaration
 class Game;
 
+/**
+ * @brief Optional TurnRecord fields, as bits of a mask. current_player and
+ * move are always recorded; a field left out keeps its default value.
+ */
+struct RecordFields {
+  static constexpr uint32_t kNone = 0;
+  static constexpr uint32_t kGame = 1u << 0;
+  static constexpr uint32_t kViews = 1u << 1;
+  static constexpr uint32_t kLegalMoves = 1u << 2;
+  static constexpr uint32_t kPossibleMoves = 1u << 3;
+  static constexpr uint32_t kAll =
+      kGame | kViews | kLegalMoves | kPossibleMoves;
+};
+
 struct TurnRecord {
 
   int current_player;
+  // Game state before the move (RecordFields::kGame)
   Game game;
+  // Each player's view before the move (RecordFields::kViews)
   std::array<PartialGame, 2> views;
-  // Legal moves for current player
-  std::vector<int> legal_moves;
-  // Possible legal moves for opponent
-  std::vector<int> possible_moves;
+  // Legal moves for current player (RecordFields::kLegalMoves)
+  std::pmr::vector<int> legal_moves;
+  // Possible legal moves for opponent (RecordFields::kPossibleMoves)
+  std::pmr::vector<int> possible_moves;
   // Move played
   Move move;
 };
@@ -34,7 +52,15 @@ struct TurnRecord {
  */
 class GameRecord {
 public:
-  GameRecord();
+  /**
+   * @param fields   RecordFields to fill in each TurnRecord; the rest are
+   *                 skipped, which saves copying states and generating moves.
+   * @param resource Allocator of the turn list and move lists, e.g. a
+   *                 per-thread arena released once the batch is exported.
+   */
+  explicit GameRecord(
+      uint32_t fields = RecordFields::kAll,
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
   /**
    * @brief Capture the initial state of the game (starting hands).
@@ -49,14 +75,31 @@ public:
    */
   void add_move(const Move &move);
 
+  /**
+   * @brief State after the deal, before the first move.
+   */
+  const Game &initial_game() const { return _initial_game; }
+
+  /**
+   * @brief Run-wide index of the game, used to join outputs written
+   * separately (features, archive, logs).
+   */
+  uint64_t game_id() const { return _game_id; }
+  void set_game_id(uint64_t game_id) { _game_id = game_id; }
+
+  uint32_t fields() const { return _fields; }
+
   const Game &game() const { return _game; }
-  const std::vector<TurnRecord> &turns() const { return _turns; }
+  const std::pmr::vector<TurnRecord> &turns() const { return _turns; }
 
 private:
+  uint64_t _game_id = 0;
+  uint32_t _fields;
+  Game _initial_game;
   Game _game;
   std::array<PartialGame, 2> _views;
   // Sequence of moves for the game
-  std::vector<TurnRecord> _turns;
+  std::pmr::vector<TurnRecord> _turns;
 };
 
 #endif // GAME_RECORD_H
@@ -1,44 +1,63 @@
 // game_simulator.cpp
 #include "game_simulator.h"
 #include "game.h"
+#include "perf_profiler.h"
 #include "player.h"
+#include "tsc_clock.h"
 #include <iostream>
 
 GameSimulator::GameSimulator(std::unique_ptr<Player> player0,
                              std::unique_ptr<Player> player1, std::mt19937 &rng,
-                             const std::string &log_file)
-    : _seed(rng() % 1000000000), _player0(std::move(player0)),
-      _player1(std::move(player1)), _rng(rng), _game(), log_file_(log_file),
-      log_enabled_(false) {
-  if (!log_file.empty()) {
-    // Construct filename: log_file + "_" + seed + ".txt"
-    std::ostringstream oss;
-    oss << log_file << "_" << _seed << ".txt";
-    std::string log_filename = oss.str();
-
-    log_stream_.open(log_filename, std::ios::out);
-    log_enabled_ = log_stream_.is_open();
-    if (!log_enabled_) {
-      std::cerr << "Warning: Could not open log file " << log_filename << "\n";
-    }
-  }
-}
+                             EventLog::Channel *log, uint64_t game_id,
+                             uint32_t record_fields,
+                             std::pmr::memory_resource *resource)
+    : _player0(std::move(player0)), _player1(std::move(player1)), _rng(rng),
+      _game(), _record(record_fields, resource),
+      _log(log && log->sampled(game_id) ? log : nullptr), _game_id(game_id) {}
 
 GameRecord GameSimulator::run() {
+  _recording = true;
+  play_game();
+
+  // Move rather than copy: a copy would leave the arena for the heap
+  return std::move(_record);
+}
+
+void GameSimulator::play() {
+  _recording = false;
+  play_game();
+}
+
+void GameSimulator::play_game() {
+  BIG2_PERF_REGION(kGame);
   // Initialize game state and inform players
   initialize_game();
 
   // Record initial deal
-  _record.set_initial_state(_game);
+  if (_recording) {
+    _record.set_game_id(_game_id);
+    _record.set_initial_state(_game);
+  }
 
-  if (log_enabled_) {
-    log_stream_ << "Initial state:\n" << _game << std::endl;
+  if (_log) {
+    _log->log_deal(_game_id, _game);
+  }
+  if (_observer) {
+    _observer->on_deal(_game);
   }
 
   // Main play loop
   play_loop();
 
-  return _record;
+  if (_log) {
+    _log->log_end(_game_id, _turn, _game);
+  }
+  if (_observer) {
+    _observer->on_game_end(_game, _turn);
+  }
+  if (_metrics) {
+    _metrics->add_game(_turn);
+  }
 }
 
 void GameSimulator::initialize_game() {
@@ -64,13 +83,39 @@ void GameSimulator::play_turn() {
   Player *curr_player = (current == 0 ? _player0.get() : _player1.get());
   Player *other_player = (current == 0 ? _player1.get() : _player0.get());
 
-  auto move = curr_player->select_move();
+  uint64_t start = _metrics ? RunMetrics::now_ns() : 0;
+  const uint64_t ticks = _latency ? TscClock::now() : 0;
+  auto move = [&] {
+    BIG2_PERF_REGION(kSelectMove);
+    return curr_player->select_move();
+  }();
+  if (_latency) {
+    // The player's own count, read after the clock stops; generating the
+    // moves again here would double the work and warm the cache for it
+    const uint64_t elapsed = TscClock::now() - ticks;
+    _latency->add(current, curr_player->last_num_legal_moves(), elapsed);
+  }
+  if (_metrics) {
+    start = _metrics->lap(RunMetrics::kSelectMove, start);
+  }
 
   _game.apply_move(move);
-  _record.add_move(move);
   other_player->accept_opponent_move(move);
+  if (_metrics) {
+    start = _metrics->lap(RunMetrics::kApplyMove, start);
+  }
+  if (_recording) {
+    _record.add_move(move);
+    if (_metrics) {
+      _metrics->lap(RunMetrics::kRecord, start);
+    }
+  }
 
-  if (log_enabled_) {
-    log_stream_ << "Game state:\n" << _game << std::endl;
+  if (_log) {
+    _log->log_move(_game_id, _turn, move, _game);
+  }
+  if (_observer) {
+    _observer->on_move(current, move, _game);
   }
+  ++_turn;
 }
\ No newline at end of file
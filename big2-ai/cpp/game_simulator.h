@@ -2,14 +2,19 @@
 #ifndef GAME_SIMULATOR_H
 #define GAME_SIMULATOR_H
 
-#include <fstream>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <random>
 #include <string>
 
 #include "game.h" // Internal game state representation
+#include "agent_latency.h"
+#include "event_log.h"
+#include "game_observer.h"
 #include "game_record.h"
 #include "player.h"
+#include "run_metrics.h"
 
 /**
  * @brief Simulates a single Big 2 game between two players using an internal
@@ -22,10 +27,17 @@ public:
    * @param player0    The Agent playing as Player 0 (first move).
    * @param player1    The Agent playing as Player 1.
    * @param rng        A random number generator for dealing and randomness.
+   * @param log        Binary event log channel of the calling thread, or
+   *                   nullptr. Only sampled games are logged.
+   * @param game_id    Identifier of this game in the record and the log.
+   * @param record_fields RecordFields to fill in the returned record.
+   * @param resource   Allocator of the record's turn data.
    */
-  GameSimulator(std::unique_ptr<Player> player0,
-                std::unique_ptr<Player> player1, std::mt19937 &rng,
-                const std::string &log_path = "");
+  GameSimulator(
+      std::unique_ptr<Player> player0, std::unique_ptr<Player> player1,
+      std::mt19937 &rng, EventLog::Channel *log = nullptr,
+      uint64_t game_id = 0, uint32_t record_fields = RecordFields::kAll,
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
   /**
    * @brief Run the game to completion and return its record.
@@ -33,24 +45,55 @@ public:
    */
   GameRecord run();
 
+  /**
+   * @brief Play the game to completion without keeping a record; only the
+   * observer and the event log see it.
+   */
+  void play();
+
+  /**
+   * @brief Receive callbacks for every deal, move and result (not owned).
+   */
+  void set_observer(GameObserver *observer) { _observer = observer; }
+
+  /**
+   * @brief Count the game and time move selection, move application and
+   * recording into this thread's slot (not owned; nullptr disables).
+   */
+  void set_metrics(RunMetrics::Counters *metrics) { _metrics = metrics; }
+
+  /**
+   * @brief Time every select_move() with TscClock into `latency`, by seat
+   * and legal move count (not owned; nullptr disables).
+   */
+  void set_latency(AgentLatency *latency) { _latency = latency; }
+
 private:
-  int _seed;
   std::unique_ptr<Player> _player0;
   std::unique_ptr<Player> _player1;
   std::mt19937 &_rng;
   Game _game; // Internal game state, handles deck, hands, tricks, scoring
   GameRecord _record;
+  bool _recording = true;
+  GameObserver *_observer = nullptr;
+  RunMetrics::Counters *_metrics = nullptr;
+  AgentLatency *_latency = nullptr;
 
   // Logging
-  std::string log_file_;
-  std::ofstream log_stream_;
-  bool log_enabled_ = false;
+  EventLog::Channel *_log;
+  uint64_t _game_id;
+  int _turn = 0;
 
   /**
    * @brief Initialize the game: shuffle, deal, determine initiative.
    */
   void initialize_game();
 
+  /**
+   * @brief Deal and play a whole game, recording it if `_recording`.
+   */
+  void play_game();
+
   /**
    * @brief Main loop: alternate between players until game over.
    */
@@ -55,6 +55,7 @@ public:
 
   Move select_move() override {
     std::vector<int> legal = game_.get_legal_moves();
+    num_legal_ = static_cast<int>(legal.size());
 
     // Separate pass moves from real moves
     std::vector<int> nonpass_moves;
@@ -87,8 +88,11 @@ public:
     return chosen_move;
   }
 
+  int last_num_legal_moves() const override { return num_legal_; }
+
 private:
   PartialGame game_;
+  int num_legal_ = 0;
 
   GreedyEval evaluate_after_move(const PartialGame &base,
                                  const Move &move) const {
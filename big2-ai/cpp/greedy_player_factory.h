@@ -21,6 +21,8 @@ public:
   std::unique_ptr<Player> create_player() override {
     return std::make_unique<GreedyPlayer>();
   }
+
+  std::string name() const override { return "greedy"; }
 };
 
 #endif // GREEDY_PLAYER_FACTORY_H
@@ -1,11 +1,16 @@
+#include "feature_set.h"
 #include "game_coordinator.h"
+#include "game_id_feature.h"
 #include "greedy_player_factory.h"
 #include "length_feature.h"
 #include "next_player_feature.h"
 #include "opponent_hand_size_feature.h"
 #include "outcome_feature.h"
+#include "perspective_feature.h"
 #include "player_hand_size_feature.h"
 #include "random_player_factory.h"
+#include "turn_game_id_feature.h"
+#include "turn_index_feature.h"
 #include "turn_outcome_feature.h"
 #include <iostream>
 #include <memory>
@@ -13,15 +18,13 @@
 #include <thread>
 #include <vector>
 
-// Helper to instantiate and register features
+// Helper to build a compile-time feature pipeline and report its columns
 template <typename... FeatureTypes>
-std::vector<std::shared_ptr<FeatureExtractor>> make_feature_list() {
-  std::vector<std::shared_ptr<FeatureExtractor>> features;
-  (void)std::initializer_list<int>{(
-      features.push_back(std::make_shared<FeatureTypes>()),
-      std::cout << "Added feature: " << std::make_shared<FeatureTypes>()->name()
-                << std::endl,
-      0)...};
+std::shared_ptr<FeaturePipeline> make_feature_list() {
+  auto features = std::make_shared<FeatureSet<FeatureTypes...>>();
+  for (const auto &name : features->names()) {
+    std::cout << "Added feature: " << name << std::endl;
+  }
   return features;
 }
 
@@ -42,27 +45,51 @@ int main() {
   auto factory1 = std::make_shared<GreedyPlayerFactory>();
 
   // ----------- DEFINE FEATURES HERE -------------
+  // The key columns come first so rows join with the game records, the
+  // archive and big2-extract output whatever their order (shuffled and
+  // partitioned outputs do not keep game order)
   auto game_features =
-      make_feature_list<OutcomeFeature, GameLengthExtractor
+      make_feature_list<GameIdFeature, OutcomeFeature, GameLengthExtractor
                         // Add more game-level feature classes here
                         >();
 
   auto turn_features =
-      make_feature_list<TurnOutcomeFeature, NextPlayerFeature,
-                        PlayerHandSizeFeature, OpponentHandSizeFeature
+      make_feature_list<TurnGameIdFeature, TurnIndexFeature,
+                        PerspectiveFeature, TurnOutcomeFeature,
+                        NextPlayerFeature, PlayerHandSizeFeature,
+                        OpponentHandSizeFeature
                         // Add more turn-level feature classes here
                         >();
   // ------------------------------------------------
 
-  std::cout << "Game features: " << game_features.size() << std::endl;
-  std::cout << "Turn features: " << turn_features.size() << std::endl;
+  std::cout << "Game features: " << game_features->num_columns() << std::endl;
+  std::cout << "Turn features: " << turn_features->num_columns() << std::endl;
 
   GameCoordinator coordinator(factory0, factory1, num_games, output_path,
                               num_threads, seed, "", game_features,
                               turn_features);
 
+  // Parquet encoding: zstd, dictionary/RLE for small integer columns
+  ParquetWriterConfig parquet_config;
+  parquet_config.compression = arrow::Compression::ZSTD;
+  parquet_config.compression_level = 3;
+  parquet_config.row_group_size = 1 << 20;
+  // zstd encoding is the bottleneck on many-core machines; spread the
+  // columns of each row group over Arrow's CPU pool
+  parquet_config.use_threads = num_threads > 1;
+  coordinator.set_parquet_config(parquet_config);
+
+  // Keep every game (about 30 bytes each) so big2-extract can add features
+  // later without re-simulating
+  coordinator.set_archive_output("games.b2arc");
+
   std::cout << "Starting simulation..." << std::endl;
-  coordinator.run_all("game_features.parquet", "turn_features.parquet");
+  try {
+    coordinator.run_all("game_features.parquet", "turn_features.parquet");
+  } catch (const std::exception &e) {
+    std::cerr << "Simulation failed: " << e.what() << std::endl;
+    return 1;
+  }
   std::cout << "Simulation completed." << std::endl;
 
   std::cout << "Done.\n";
@@ -0,0 +1,98 @@
+// async_table_writer.cpp
+#include "async_table_writer.h"
+#include "thread_name.h"
+#include "trace_recorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+
+AsyncTableWriter::AsyncTableWriter(std::unique_ptr<TableWriter> inner,
+                                   size_t max_pending)
+    : _inner(std::move(inner)), _max_pending(std::max<size_t>(max_pending, 1)),
+      _thread(&AsyncTableWriter::run, this) {}
+
+AsyncTableWriter::~AsyncTableWriter() {
+  if (!_closed) {
+    try {
+      close();
+    } catch (const std::exception &e) {
+      std::cerr << "Error closing background writer: " << e.what()
+                << std::endl;
+    }
+  }
+}
+
+void AsyncTableWriter::run() {
+  static std::atomic<int> next_id{0};
+  ThreadName::set("table writer " + std::to_string(next_id++));
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _changed.wait(lock, [&] { return !_pending.empty() || _closing; });
+    if (_pending.empty()) {
+      break;
+    }
+    auto table = _pending.front();
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      TraceSpan span("write_table");
+      _inner->write(*table);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    table.reset();
+    lock.lock();
+    _pending.pop_front();
+    if (error && !_error) {
+      _error = error;
+    }
+    _changed.notify_all();
+  }
+}
+
+void AsyncTableWriter::rethrow_error() {
+  if (_error) {
+    std::rethrow_exception(_error);
+  }
+}
+
+void AsyncTableWriter::write(const arrow::Table &table) {
+  // Shallow copy: the new table shares the column buffers
+  auto shared = arrow::Table::Make(table.schema(), table.columns(),
+                                   table.num_rows());
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (_closing) {
+    throw std::logic_error("AsyncTableWriter: write after close.");
+  }
+  rethrow_error();
+  {
+    TraceSpan span("wait_on_queue");
+    _changed.wait(lock, [&] { return _pending.size() < _max_pending; });
+  }
+  rethrow_error();
+  _pending.push_back(std::move(shared));
+  _changed.notify_all();
+}
+
+size_t AsyncTableWriter::pending() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _pending.size();
+}
+
+void AsyncTableWriter::close() {
+  if (_closed) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _closing = true;
+  }
+  _changed.notify_all();
+  _thread.join();
+  _closed = true;
+  // A failed batch must not end up behind a valid footer
+  rethrow_error();
+  _inner->close();
+}
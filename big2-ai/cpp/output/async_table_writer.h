@@ -0,0 +1,57 @@
+// async_table_writer.h
+#ifndef ASYNC_TABLE_WRITER_H
+#define ASYNC_TABLE_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <arrow/api.h>
+
+#include "table_writer.h"
+
+/**
+ * @brief Runs another TableWriter on a background thread.
+ *
+ * write() hands the table over (sharing its buffers, no copy) and returns,
+ * so encoding and compression of one batch overlap with simulating and
+ * extracting the next. At most `max_pending` tables wait in the queue;
+ * write() blocks beyond that to bound memory. An error on the background
+ * thread is sticky: every later write() and close() rethrows it, and close()
+ * then leaves the inner writer unfinalized rather than completing a file
+ * that is missing a batch.
+ */
+class AsyncTableWriter : public TableWriter {
+public:
+  explicit AsyncTableWriter(std::unique_ptr<TableWriter> inner,
+                            size_t max_pending = 2);
+  ~AsyncTableWriter() override;
+
+  void write(const arrow::Table &table) override;
+  void close() override;
+
+  /**
+   * @brief Tables waiting to be written by the background thread.
+   */
+  size_t pending();
+
+private:
+  std::unique_ptr<TableWriter> _inner;
+  size_t _max_pending;
+
+  std::mutex _mutex;
+  std::condition_variable _changed;
+  std::deque<std::shared_ptr<arrow::Table>> _pending;
+  bool _closing = false;
+  bool _closed = false;
+  std::exception_ptr _error;
+  std::thread _thread;
+
+  void run();
+  void rethrow_error();
+};
+
+#endif // ASYNC_TABLE_WRITER_H
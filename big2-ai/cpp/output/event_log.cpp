@@ -0,0 +1,199 @@
+// event_log.cpp
+#include "event_log.h"
+#include "game.h"
+#include "uring_file_sink.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+static uint64_t mix(uint64_t h, uint64_t v) {
+  // splitmix64 finalizer over the running hash
+  h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  return h ^ (h >> 31);
+}
+
+// Both hands and the discard pile, 4 bits per rank, plus turn and last move
+static uint64_t state_hash(const Game &game) {
+  uint64_t h = 0;
+  for (int player = 0; player < 2; ++player) {
+    uint64_t packed = 0;
+    auto hand = game.player_hand(player);
+    for (int r = 0; r < 13; ++r)
+      packed |= static_cast<uint64_t>(hand[r]) << (4 * r);
+    h = mix(h, packed);
+  }
+  uint64_t discards = 0;
+  auto pile = game.discard_pile();
+  for (int r = 0; r < 13; ++r)
+    discards |= static_cast<uint64_t>(pile[r]) << (4 * r);
+  h = mix(h, discards);
+  h = mix(h, static_cast<uint64_t>(game.current_player()));
+  return mix(h, static_cast<uint64_t>(encodeMove(game.last_move())));
+}
+
+static void set_hand_sizes(LogEvent &event, const Game &game) {
+  event.hand_sizes[0] = static_cast<uint8_t>(game.get_player_hand_size(0));
+  event.hand_sizes[1] = static_cast<uint8_t>(game.get_player_hand_size(1));
+}
+
+// ---------------------------------------------------------------- Channel
+
+EventLog::Channel::Channel(size_t capacity) {
+  size_t size = 1;
+  while (size < capacity)
+    size <<= 1;
+  _ring.resize(size);
+  _mask = size - 1;
+}
+
+void EventLog::Channel::push(const LogEvent &event) {
+  const uint64_t head = _head.load(std::memory_order_relaxed);
+  if (head - _tail.load(std::memory_order_acquire) >= _ring.size()) {
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  _ring[head & _mask] = event;
+  _head.store(head + 1, std::memory_order_release);
+}
+
+void EventLog::Channel::log_deal(uint64_t game_id, const Game &game) {
+  for (int player = 0; player < 2; ++player) {
+    LogEvent event{};
+    event.game_id = game_id;
+    event.kind = LogEvent::kDeal;
+    event.player = static_cast<uint8_t>(player);
+    auto hand = game.player_hand(player);
+    for (int r = 0; r < 13; ++r)
+      event.payload |= static_cast<uint64_t>(hand[r]) << (4 * r);
+    set_hand_sizes(event, game);
+    push(event);
+  }
+}
+
+void EventLog::Channel::log_move(uint64_t game_id, int turn, const Move &move,
+                                 const Game &after) {
+  LogEvent event{};
+  event.game_id = game_id;
+  event.payload = state_hash(after);
+  event.turn = static_cast<uint16_t>(turn);
+  event.move = static_cast<uint16_t>(encodeMove(move));
+  event.kind = LogEvent::kMove;
+  // The mover is the player who is no longer to act
+  event.player = static_cast<uint8_t>(1 - after.current_player());
+  set_hand_sizes(event, after);
+  push(event);
+}
+
+void EventLog::Channel::log_end(uint64_t game_id, int turns,
+                                const Game &game) {
+  LogEvent event{};
+  event.game_id = game_id;
+  event.payload = static_cast<uint64_t>(turns);
+  event.turn = static_cast<uint16_t>(turns);
+  event.kind = LogEvent::kEnd;
+  event.player = static_cast<uint8_t>(game.get_winner());
+  set_hand_sizes(event, game);
+  push(event);
+}
+
+// ---------------------------------------------------------------- EventLog
+
+EventLog::EventLog(const std::string &prefix, int num_threads,
+                   uint64_t sample_every, size_t ring_capacity) {
+  for (int t = 0; t < num_threads; ++t) {
+    auto channel = std::make_unique<Channel>(ring_capacity);
+    channel->_sample_every = sample_every == 0 ? 1 : sample_every;
+    _channels.push_back(std::move(channel));
+
+    auto file = std::make_unique<UringFileSink>(
+        prefix + "_thread" + std::to_string(t) + ".b2log", 1 << 18, 4);
+    LogFileHeader header{};
+    std::memcpy(header.magic, kLogMagic, sizeof(header.magic));
+    header.version = 1;
+    header.event_size = sizeof(LogEvent);
+    header.thread = static_cast<uint32_t>(t);
+    file->write(&header, sizeof(header));
+    _files.push_back(std::move(file));
+  }
+  _drainer = std::thread(&EventLog::drain_loop, this);
+}
+
+EventLog::~EventLog() {
+  try {
+    close();
+  } catch (const std::exception &e) {
+    std::cerr << "Error closing event log: " << e.what() << std::endl;
+  }
+}
+
+bool EventLog::drain(size_t index) {
+  Channel &channel = *_channels[index];
+  const uint64_t tail = channel._tail.load(std::memory_order_relaxed);
+  const uint64_t head = channel._head.load(std::memory_order_acquire);
+  if (head == tail) {
+    return false;
+  }
+  // At most two contiguous pieces: up to the end of the ring, then the rest
+  const size_t size = channel._ring.size();
+  const size_t first = tail & channel._mask;
+  const size_t count = head - tail;
+  const size_t part = std::min(count, size - first);
+  _files[index]->write(&channel._ring[first], part * sizeof(LogEvent));
+  if (count > part) {
+    _files[index]->write(&channel._ring[0],
+                         (count - part) * sizeof(LogEvent));
+  }
+  channel._tail.store(head, std::memory_order_release);
+  return true;
+}
+
+void EventLog::drain_loop() {
+  while (!_stopping.load(std::memory_order_acquire)) {
+    bool any = false;
+    try {
+      for (size_t i = 0; i < _channels.size(); ++i)
+        any |= drain(i);
+    } catch (const std::exception &e) {
+      std::cerr << "Error writing event log: " << e.what() << std::endl;
+      return;
+    }
+    if (!any) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+}
+
+size_t EventLog::pending() const {
+  size_t total = 0;
+  for (const auto &channel : _channels) {
+    // Tail first: it never passes the head read after it
+    const uint64_t tail = channel->_tail.load(std::memory_order_acquire);
+    total += channel->_head.load(std::memory_order_acquire) - tail;
+  }
+  return total;
+}
+
+void EventLog::close() {
+  if (!_drainer.joinable()) {
+    return;
+  }
+  _stopping.store(true, std::memory_order_release);
+  _drainer.join();
+
+  uint64_t dropped = 0;
+  for (size_t i = 0; i < _channels.size(); ++i) {
+    drain(i);
+    _files[i]->close();
+    dropped += _channels[i]->_dropped.load();
+  }
+  if (dropped > 0) {
+    std::cerr << "Warning: event log dropped " << dropped
+              << " events (ring buffers full)\n";
+  }
+}
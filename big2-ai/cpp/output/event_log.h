@@ -0,0 +1,123 @@
+// event_log.h
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "move.h"
+
+class Game;
+class UringFileSink;
+
+/**
+ * @brief One fixed-size binary log record.
+ */
+struct LogEvent {
+  enum Kind : uint8_t { kDeal = 0, kMove = 1, kEnd = 2 };
+
+  uint64_t game_id;
+  // kDeal: the player's hand, 4 bits per rank (3 in the low bits);
+  // kMove: hash of the full game state after the move;
+  // kEnd:  number of turns played
+  uint64_t payload;
+  uint16_t turn;
+  // encodeMove() id (kMove only)
+  uint16_t move;
+  uint8_t kind;
+  // kDeal/kMove: the player; kEnd: the winner
+  uint8_t player;
+  uint8_t hand_sizes[2];
+};
+static_assert(sizeof(LogEvent) == 24, "LogEvent is a fixed on-disk record");
+
+/**
+ * @brief File layout: this header, then LogEvents back to back.
+ */
+struct LogFileHeader {
+  char magic[6];
+  uint16_t version;
+  uint32_t event_size;
+  uint32_t thread;
+};
+static_assert(sizeof(LogFileHeader) == 16, "LogFileHeader is on disk");
+
+inline constexpr char kLogMagic[6] = {'B', '2', 'L', 'O', 'G', '\0'};
+
+/**
+ * @brief Binary game log with one lock-free ring buffer per thread.
+ *
+ * Simulation threads append compact events to their own Channel and never
+ * touch the disk; a background thread drains every channel into
+ * `<prefix>_thread<k>.b2log`. When a ring is full the event is dropped and
+ * counted rather than stalling the simulation. `big2-logcat` renders the
+ * files as text.
+ */
+class EventLog {
+public:
+  /**
+   * @brief Single-producer ring buffer owned by one simulation thread.
+   */
+  class Channel {
+  public:
+    explicit Channel(size_t capacity);
+
+    bool sampled(uint64_t game_id) const {
+      return game_id % _sample_every == 0;
+    }
+
+    void log_deal(uint64_t game_id, const Game &game);
+    void log_move(uint64_t game_id, int turn, const Move &move,
+                  const Game &after);
+    void log_end(uint64_t game_id, int turns, const Game &game);
+
+  private:
+    friend class EventLog;
+
+    std::vector<LogEvent> _ring;
+    size_t _mask;
+    uint64_t _sample_every = 1;
+    alignas(64) std::atomic<uint64_t> _head{0};
+    alignas(64) std::atomic<uint64_t> _tail{0};
+    std::atomic<uint64_t> _dropped{0};
+
+    void push(const LogEvent &event);
+  };
+
+  /**
+   * @param prefix        Path prefix of the per-thread files.
+   * @param num_threads   Number of channels (one per simulation thread).
+   * @param sample_every  Log only games whose id is a multiple of this.
+   * @param ring_capacity Events per channel, rounded up to a power of two.
+   */
+  EventLog(const std::string &prefix, int num_threads,
+           uint64_t sample_every = 1, size_t ring_capacity = 1 << 16);
+  ~EventLog();
+
+  Channel &channel(int thread) { return *_channels.at(thread); }
+
+  /**
+   * @brief Events waiting in all rings for the drain thread.
+   */
+  size_t pending() const;
+
+  /**
+   * @brief Drain the remaining events, close the files and report drops.
+   */
+  void close();
+
+private:
+  std::vector<std::unique_ptr<Channel>> _channels;
+  std::vector<std::unique_ptr<UringFileSink>> _files;
+  std::atomic<bool> _stopping{false};
+  std::thread _drainer;
+
+  void drain_loop();
+  bool drain(size_t index);
+};
+
+#endif // EVENT_LOG_H
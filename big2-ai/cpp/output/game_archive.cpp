@@ -0,0 +1,222 @@
+// game_archive.cpp
+#include "game_archive.h"
+#include "game.h"
+#include "game_record.h"
+#include "move.h"
+#include "uring_file_sink.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// ---------------------------------------------------------------- Codec
+
+static uint8_t *put_varint(uint8_t *out, uint64_t value) {
+  while (value >= 0x80) {
+    *out++ = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  *out++ = static_cast<uint8_t>(value);
+  return out;
+}
+
+static uint64_t get_varint(const uint8_t *&in, const uint8_t *end) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (in == end) {
+      throw std::runtime_error("GameArchive: truncated record.");
+    }
+    const uint8_t byte = *in++;
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return value;
+    }
+  }
+  throw std::runtime_error("GameArchive: malformed varint.");
+}
+
+// A hand holds at most 4 copies of a rank, so 13 counts fit in base 5
+static uint32_t pack_hand(const std::array<int, 13> &hand) {
+  uint32_t packed = 0;
+  for (int r = 12; r >= 0; --r) {
+    packed = packed * 5 + static_cast<uint32_t>(hand[r]);
+  }
+  return packed;
+}
+
+static std::array<int, 13> unpack_hand(uint32_t packed) {
+  std::array<int, 13> hand{};
+  for (int r = 0; r < 13; ++r) {
+    hand[r] = static_cast<int>(packed % 5);
+    packed /= 5;
+  }
+  return hand;
+}
+
+static uint8_t *put_u32(uint8_t *out, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    *out++ = static_cast<uint8_t>(value >> (8 * i));
+  }
+  return out;
+}
+
+static uint32_t get_u32(const uint8_t *in) {
+  return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8 |
+         static_cast<uint32_t>(in[2]) << 16 |
+         static_cast<uint32_t>(in[3]) << 24;
+}
+
+uint8_t *GameArchiveCodec::encode(const GameRecord &record, uint8_t *out) {
+  const Game &initial = record.initial_game();
+  out = put_u32(out, pack_hand(initial.player_hand(0)));
+  out = put_u32(out, pack_hand(initial.player_hand(1)));
+  *out++ = static_cast<uint8_t>(initial.current_player() |
+                                record.game().get_winner() << 1);
+  const auto &turns = record.turns();
+  out = put_varint(out, turns.size());
+  for (const auto &turn : turns) {
+    out = put_varint(out, static_cast<uint64_t>(encodeMove(turn.move)));
+  }
+  return out;
+}
+
+ArchivedGame GameArchiveCodec::decode(const uint8_t *in, const uint8_t *end) {
+  if (end - in < 9) {
+    throw std::runtime_error("GameArchive: truncated record.");
+  }
+  ArchivedGame game;
+  game.hands[0] = unpack_hand(get_u32(in));
+  game.hands[1] = unpack_hand(get_u32(in + 4));
+  game.first_player = in[8] & 1;
+  game.winner = (in[8] >> 1) & 1;
+  in += 9;
+  const uint64_t num_moves = get_varint(in, end);
+  if (num_moves > static_cast<uint64_t>(end - in)) {
+    throw std::runtime_error("GameArchive: truncated record.");
+  }
+  game.moves.resize(num_moves);
+  for (auto &move : game.moves) {
+    const uint64_t id = get_varint(in, end);
+    if (id >= static_cast<uint64_t>(LEGAL_MOVES_SIZE)) {
+      throw std::runtime_error("GameArchive: bad move id.");
+    }
+    move = static_cast<int>(id);
+  }
+  return game;
+}
+
+GameRecord ArchivedGame::replay(uint32_t fields) const {
+  Game game;
+  game.deal(hands, first_player);
+  GameRecord record(fields);
+  record.set_game_id(game_id);
+  record.set_initial_state(game);
+  for (int id : moves) {
+    record.add_move(Move(id));
+  }
+  return record;
+}
+
+// ---------------------------------------------------------------- Writer
+
+GameArchiveWriter::GameArchiveWriter(const std::string &path)
+    : _path(path), _sink(std::make_unique<UringFileSink>(path)) {
+  // Placeholder header; rewritten with the index location on close()
+  ArchiveFileHeader header{};
+  _sink->write(&header, sizeof(header));
+}
+
+GameArchiveWriter::~GameArchiveWriter() {
+  try {
+    close();
+  } catch (const std::exception &e) {
+    std::cerr << "Error closing " << _path << ": " << e.what() << std::endl;
+  }
+}
+
+void GameArchiveWriter::write(
+    const uint8_t *data, size_t length,
+    const std::vector<std::pair<uint64_t, size_t>> &games) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_sink->closed()) {
+    throw std::logic_error("GameArchiveWriter: write after close.");
+  }
+  const uint64_t base = static_cast<uint64_t>(_sink->tell());
+  for (const auto &[game_id, offset] : games) {
+    if (game_id >= _offsets.size()) {
+      _offsets.resize(std::max<uint64_t>(game_id + 1, _offsets.size() * 2));
+    }
+    _offsets[game_id] = base + offset;
+    _num_games = std::max(_num_games, game_id + 1);
+  }
+  _sink->write(data, length);
+  _bytes_written += length;
+}
+
+void GameArchiveWriter::close() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_sink->closed()) {
+    return;
+  }
+  ArchiveFileHeader header{};
+  std::memcpy(header.magic, kArchiveMagic, sizeof(header.magic));
+  header.version = 1;
+  header.num_games = _num_games;
+  header.index_offset = static_cast<uint64_t>(_sink->tell());
+  _offsets.resize(_num_games);
+  _sink->write(_offsets.data(), _offsets.size() * sizeof(uint64_t));
+  _sink->close();
+  _offsets = {};
+
+  int fd = ::open(_path.c_str(), O_WRONLY);
+  bool ok = fd >= 0 &&
+            ::pwrite(fd, &header, sizeof(header), 0) == sizeof(header);
+  if (fd >= 0 && ::close(fd) != 0) {
+    ok = false;
+  }
+  if (!ok) {
+    throw std::runtime_error("GameArchiveWriter: cannot finalize '" + _path +
+                             "': " + std::strerror(errno));
+  }
+}
+
+GameArchiveWriter::Buffer::Buffer(GameArchiveWriter &writer, size_t capacity)
+    : _writer(writer), _data(capacity) {}
+
+GameArchiveWriter::Buffer::~Buffer() {
+  try {
+    flush();
+  } catch (const std::exception &e) {
+    std::cerr << "Error flushing game archive: " << e.what() << std::endl;
+  }
+}
+
+void GameArchiveWriter::Buffer::flush() {
+  if (_size > 0) {
+    _writer.write(_data.data(), _size, _games);
+    _size = 0;
+    _games.clear();
+  }
+}
+
+void GameArchiveWriter::Buffer::append(uint64_t game_id,
+                                       const GameRecord &record) {
+  const size_t max_bytes = GameArchiveCodec::kMaxFixedBytes +
+                           record.turns().size() *
+                               GameArchiveCodec::kMaxMoveBytes;
+  if (_size + max_bytes > _data.size()) {
+    flush();
+    if (max_bytes > _data.size()) {
+      _data.resize(max_bytes);
+    }
+  }
+  _games.emplace_back(game_id, _size);
+  uint8_t *end = GameArchiveCodec::encode(record, _data.data() + _size);
+  _size = end - _data.data();
+}
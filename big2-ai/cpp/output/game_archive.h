@@ -0,0 +1,133 @@
+// game_archive.h
+#ifndef GAME_ARCHIVE_H
+#define GAME_ARCHIVE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "game_record.h"
+
+class UringFileSink;
+
+/**
+ * @brief File layout: this header, the game records, then the index.
+ *
+ * The index is `num_games` little-endian uint64 file offsets, one per game
+ * id; 0 marks a game that was never written. Each record is
+ *   - the deal: each hand's 13 rank counts as a base-5 number (uint32 LE),
+ *   - one byte: bit 0 the first player, bit 1 the winner,
+ *   - a varint move count, then each encodeMove() id as a varint.
+ */
+struct ArchiveFileHeader {
+  char magic[6];
+  uint16_t version;
+  uint64_t num_games;
+  uint64_t index_offset;
+};
+static_assert(sizeof(ArchiveFileHeader) == 24, "ArchiveFileHeader is on disk");
+
+inline constexpr char kArchiveMagic[6] = {'B', '2', 'A', 'R', 'C', '\0'};
+
+/**
+ * @brief Deal, players and moves of one archived game.
+ */
+struct ArchivedGame {
+  uint64_t game_id = 0;
+  std::array<std::array<int, 13>, 2> hands;
+  int first_player = 0;
+  int winner = 0;
+  // encodeMove() ids in play order
+  std::vector<int> moves;
+
+  /**
+   * @brief Rebuild the record (turns, legal moves, views) by replaying the
+   * moves from the deal, filling in the given RecordFields.
+   */
+  GameRecord replay(uint32_t fields = RecordFields::kAll) const;
+};
+
+/**
+ * @brief Encoding of ArchivedGame records shared by the writer and reader.
+ */
+class GameArchiveCodec {
+public:
+  // Deal, flag byte and a one-byte move count; moves add 1-2 bytes each
+  static constexpr size_t kMaxFixedBytes = 4 + 4 + 1 + 5;
+  static constexpr size_t kMaxMoveBytes = 2;
+
+  /**
+   * @brief Encode a finished game at `out`; returns one past the end.
+   * `out` needs kMaxFixedBytes + kMaxMoveBytes per move.
+   */
+  static uint8_t *encode(const GameRecord &record, uint8_t *out);
+
+  /**
+   * @brief Decode the record starting at `in`, reading no further than
+   * `end`. Throws on a truncated or malformed record.
+   */
+  static ArchivedGame decode(const uint8_t *in, const uint8_t *end);
+};
+
+/**
+ * @brief Appends finished games to a compact archive indexed by game id.
+ *
+ * Games cost roughly 10 bytes plus 1-2 bytes per move on disk. Workers
+ * encode into their own Buffer and hand full buffers to the writer, which
+ * appends them through an io_uring sink under a mutex and records each
+ * game's offset. The index and final header are written on close().
+ */
+class GameArchiveWriter {
+public:
+  explicit GameArchiveWriter(const std::string &path);
+  ~GameArchiveWriter();
+
+  GameArchiveWriter(const GameArchiveWriter &) = delete;
+  GameArchiveWriter &operator=(const GameArchiveWriter &) = delete;
+
+  /**
+   * @brief Per-thread encoding buffer; flushes to the writer when full and
+   * on destruction.
+   */
+  class Buffer {
+  public:
+    explicit Buffer(GameArchiveWriter &writer, size_t capacity = 1 << 20);
+    ~Buffer();
+
+    void append(uint64_t game_id, const GameRecord &record);
+    void flush();
+
+  private:
+    GameArchiveWriter &_writer;
+    std::vector<uint8_t> _data;
+    size_t _size = 0;
+    // (game id, offset within _data) of the games held
+    std::vector<std::pair<uint64_t, size_t>> _games;
+  };
+
+  uint64_t num_games() const { return _num_games; }
+  size_t bytes_written() const { return _bytes_written; }
+
+  /**
+   * @brief Write the index and header and close the file.
+   */
+  void close();
+
+private:
+  std::string _path;
+  std::unique_ptr<UringFileSink> _sink;
+  std::mutex _mutex;
+  std::vector<uint64_t> _offsets;
+  uint64_t _num_games = 0;
+  size_t _bytes_written = 0;
+
+  void write(const uint8_t *data, size_t length,
+             const std::vector<std::pair<uint64_t, size_t>> &games);
+};
+
+#endif // GAME_ARCHIVE_H
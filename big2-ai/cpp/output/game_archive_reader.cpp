@@ -0,0 +1,111 @@
+// game_archive_reader.cpp
+#include "game_archive_reader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static std::runtime_error format_error(const std::string &what,
+                                       const std::string &path) {
+  return std::runtime_error("GameArchiveReader: " + what + " '" + path + "'.");
+}
+
+GameArchiveReader::GameArchiveReader(const std::string &path) : _path(path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("GameArchiveReader: cannot open '" + path +
+                             "': " + std::strerror(errno));
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw format_error("cannot stat", path);
+  }
+  _size = static_cast<size_t>(st.st_size);
+  if (_size < sizeof(ArchiveFileHeader)) {
+    ::close(fd);
+    throw format_error("too short to be an archive", path);
+  }
+  void *map = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    throw std::runtime_error("GameArchiveReader: cannot map '" + path +
+                             "': " + std::strerror(errno));
+  }
+  _data = static_cast<const uint8_t *>(map);
+
+  ArchiveFileHeader header;
+  std::memcpy(&header, _data, sizeof(header));
+  const uint64_t index_bytes = header.num_games * sizeof(uint64_t);
+  if (std::memcmp(header.magic, kArchiveMagic, sizeof(header.magic)) != 0 ||
+      header.version != 1 || header.index_offset < sizeof(header) ||
+      header.index_offset > _size ||
+      index_bytes != _size - header.index_offset) {
+    ::munmap(const_cast<uint8_t *>(_data), _size);
+    throw format_error("bad header in", path);
+  }
+  _num_games = header.num_games;
+  _index = _data + header.index_offset;
+  // Records end where the index begins
+  _records_end = _index;
+  ::madvise(const_cast<uint8_t *>(_data), _size, MADV_RANDOM);
+}
+
+GameArchiveReader::~GameArchiveReader() {
+  if (_data) {
+    ::munmap(const_cast<uint8_t *>(_data), _size);
+  }
+}
+
+uint64_t GameArchiveReader::offset(uint64_t game_id) const {
+  uint64_t value;
+  std::memcpy(&value, _index + game_id * sizeof(uint64_t), sizeof(value));
+  return value;
+}
+
+ArchivedGame GameArchiveReader::game(uint64_t game_id) const {
+  if (!contains(game_id)) {
+    throw std::out_of_range("GameArchiveReader: game " +
+                            std::to_string(game_id) + " not in '" + _path +
+                            "'.");
+  }
+  const uint64_t start = offset(game_id);
+  if (start < sizeof(ArchiveFileHeader) || _data + start >= _records_end) {
+    throw format_error("bad index entry in", _path);
+  }
+  ArchivedGame game = GameArchiveCodec::decode(_data + start, _records_end);
+  game.game_id = game_id;
+  return game;
+}
+
+std::vector<GameRecord> GameArchiveReader::records(uint64_t first,
+                                                   size_t count,
+                                                   uint32_t fields) const {
+  std::vector<GameRecord> out;
+  const uint64_t end = std::min<uint64_t>(first + count, _num_games);
+  for (uint64_t id = first; id < end; ++id) {
+    if (contains(id)) {
+      out.push_back(record(id, fields));
+    }
+  }
+  return out;
+}
+
+// ---------------------------------------------------------------- Cursor
+
+GameArchiveReader::Cursor::Cursor(ArchivedGame game)
+    : _archived(std::move(game)) {
+  _game.deal(_archived.hands, _archived.first_player);
+}
+
+void GameArchiveReader::Cursor::advance() {
+  _game.apply_move(next_move());
+  ++_turn;
+}
@@ -0,0 +1,102 @@
+// game_archive_reader.h
+#ifndef GAME_ARCHIVE_READER_H
+#define GAME_ARCHIVE_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "game.h"
+#include "game_archive.h"
+#include "game_record.h"
+
+/**
+ * @brief Random-access reader over a memory-mapped game archive.
+ *
+ * Opening maps the file and validates the header; game n is then one index
+ * lookup and a decode of its few bytes. Reads are const and may run from
+ * several threads at once.
+ */
+class GameArchiveReader {
+public:
+  explicit GameArchiveReader(const std::string &path);
+  ~GameArchiveReader();
+
+  GameArchiveReader(const GameArchiveReader &) = delete;
+  GameArchiveReader &operator=(const GameArchiveReader &) = delete;
+
+  /**
+   * @brief One past the largest game id in the archive.
+   */
+  uint64_t num_games() const { return _num_games; }
+
+  /**
+   * @brief Whether game `game_id` was written (ids may have gaps).
+   */
+  bool contains(uint64_t game_id) const {
+    return game_id < _num_games && offset(game_id) != 0;
+  }
+
+  /**
+   * @brief Deal and moves of one game. Throws if it is not in the archive.
+   */
+  ArchivedGame game(uint64_t game_id) const;
+
+  /**
+   * @brief Replayed record of one game, ready for FeatureExtractors.
+   * @param fields RecordFields to fill in, e.g. a pipeline's
+   *               required_fields().
+   */
+  GameRecord record(uint64_t game_id,
+                    uint32_t fields = RecordFields::kAll) const {
+    return game(game_id).replay(fields);
+  }
+
+  /**
+   * @brief Replayed records of the games in [first, first + count) that
+   * exist, in id order; suitable for FeaturePipeline::extract().
+   */
+  std::vector<GameRecord> records(uint64_t first, size_t count,
+                                  uint32_t fields = RecordFields::kAll) const;
+
+  /**
+   * @brief Steps through a game state by state without building TurnRecords,
+   * for scans that only need the public game state.
+   */
+  class Cursor {
+  public:
+    explicit Cursor(ArchivedGame game);
+
+    const ArchivedGame &archived() const { return _archived; }
+    const Game &game() const { return _game; }
+    size_t turn() const { return _turn; }
+    bool done() const { return _turn == _archived.moves.size(); }
+
+    /**
+     * @brief Move about to be played from the current state.
+     */
+    Move next_move() const { return Move(_archived.moves.at(_turn)); }
+
+    void advance();
+
+  private:
+    ArchivedGame _archived;
+    Game _game;
+    size_t _turn = 0;
+  };
+
+  Cursor cursor(uint64_t game_id) const { return Cursor(game(game_id)); }
+
+private:
+  std::string _path;
+  const uint8_t *_data = nullptr;
+  size_t _size = 0;
+  uint64_t _num_games = 0;
+  const uint8_t *_index = nullptr;
+  const uint8_t *_records_end = nullptr;
+
+  uint64_t offset(uint64_t game_id) const;
+};
+
+#endif // GAME_ARCHIVE_READER_H
@@ -0,0 +1,60 @@
+// ipc_table_writer.cpp
+#include "ipc_table_writer.h"
+#include "shared_memory_stream.h"
+#include "uring_output_stream.h"
+
+#include <iostream>
+
+#include <parquet/exception.h>
+
+IpcTableWriter::IpcTableWriter(std::shared_ptr<arrow::io::OutputStream> sink,
+                               std::shared_ptr<arrow::Schema> schema,
+                               int64_t max_batch_rows)
+    : _sink(std::move(sink)), _max_batch_rows(max_batch_rows) {
+  PARQUET_ASSIGN_OR_THROW(
+      _writer,
+      arrow::ipc::MakeFileWriter(_sink, schema,
+                                 arrow::ipc::IpcWriteOptions::Defaults()));
+}
+
+IpcTableWriter::~IpcTableWriter() {
+  if (_writer) {
+    try {
+      close();
+    } catch (const std::exception &e) {
+      std::cerr << "Error closing Arrow IPC file: " << e.what() << std::endl;
+    }
+  }
+}
+
+std::unique_ptr<IpcTableWriter>
+IpcTableWriter::OpenFile(const std::string &path,
+                         std::shared_ptr<arrow::Schema> schema) {
+  std::shared_ptr<UringOutputStream> sink;
+  PARQUET_ASSIGN_OR_THROW(sink, UringOutputStream::Open(path));
+  return std::make_unique<IpcTableWriter>(sink, std::move(schema));
+}
+
+std::unique_ptr<IpcTableWriter>
+IpcTableWriter::OpenSharedMemory(const std::string &name,
+                                 std::shared_ptr<arrow::Schema> schema) {
+  std::shared_ptr<SharedMemoryOutputStream> sink;
+  PARQUET_ASSIGN_OR_THROW(sink, SharedMemoryOutputStream::Open(name));
+  return std::make_unique<IpcTableWriter>(sink, std::move(schema));
+}
+
+void IpcTableWriter::write(const arrow::Table &table) {
+  if (!_writer) {
+    throw std::logic_error("IpcTableWriter: write after close.");
+  }
+  PARQUET_THROW_NOT_OK(_writer->WriteTable(table, _max_batch_rows));
+}
+
+void IpcTableWriter::close() {
+  if (!_writer) {
+    return;
+  }
+  auto writer = std::move(_writer);
+  PARQUET_THROW_NOT_OK(writer->Close());
+  PARQUET_THROW_NOT_OK(_sink->Close());
+}
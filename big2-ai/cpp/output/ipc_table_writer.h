@@ -0,0 +1,56 @@
+// ipc_table_writer.h
+#ifndef IPC_TABLE_WRITER_H
+#define IPC_TABLE_WRITER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+#include <arrow/io/api.h>
+#include <arrow/ipc/api.h>
+
+#include "table_writer.h"
+
+/**
+ * @brief Writes tables as an Arrow IPC file (Feather v2).
+ *
+ * Buffers are stored uncompressed so readers can memory-map the output and
+ * use it without decoding. The sink is either a regular file or a POSIX
+ * shared-memory segment (see SharedMemoryOutputStream).
+ */
+class IpcTableWriter : public TableWriter {
+public:
+  /**
+   * @param sink           Stream to write to; closed by close().
+   * @param schema         Schema every appended table must match.
+   * @param max_batch_rows Maximum rows per record batch.
+   */
+  IpcTableWriter(std::shared_ptr<arrow::io::OutputStream> sink,
+                 std::shared_ptr<arrow::Schema> schema,
+                 int64_t max_batch_rows = 1 << 20);
+  ~IpcTableWriter() override;
+
+  /**
+   * @brief Open an IPC file at `path`.
+   */
+  static std::unique_ptr<IpcTableWriter>
+  OpenFile(const std::string &path, std::shared_ptr<arrow::Schema> schema);
+
+  /**
+   * @brief Open an IPC file in the shared-memory segment `name`.
+   */
+  static std::unique_ptr<IpcTableWriter>
+  OpenSharedMemory(const std::string &name,
+                   std::shared_ptr<arrow::Schema> schema);
+
+  void write(const arrow::Table &table) override;
+  void close() override;
+
+private:
+  std::shared_ptr<arrow::io::OutputStream> _sink;
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> _writer;
+  int64_t _max_batch_rows;
+};
+
+#endif // IPC_TABLE_WRITER_H
@@ -0,0 +1,128 @@
+// jsonl_record_writer.cpp
+#include "jsonl_record_writer.h"
+#include "game.h"
+#include "game_record.h"
+#include "move.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+// "00" "01" ... "99": two digits per table lookup
+static const char kDigitPairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536"
+    "37383940414243444546474849505152535455565758596061626364656667686970717273"
+    "7475767778798081828384858687888990919293949596979899";
+
+// Writes the decimal digits of `value` at `out`; returns one past the end
+static char *format_uint(char *out, uint64_t value) {
+  char digits[20];
+  char *end = digits + sizeof(digits);
+  char *p = end;
+  while (value >= 100) {
+    unsigned pair = static_cast<unsigned>(value % 100) * 2;
+    value /= 100;
+    *--p = kDigitPairs[pair + 1];
+    *--p = kDigitPairs[pair];
+  }
+  if (value >= 10) {
+    *--p = kDigitPairs[value * 2 + 1];
+    *--p = kDigitPairs[value * 2];
+  } else {
+    *--p = static_cast<char>('0' + value);
+  }
+  std::memcpy(out, p, end - p);
+  return out + (end - p);
+}
+
+static char *append_literal(char *out, const char *text, size_t length) {
+  std::memcpy(out, text, length);
+  return out + length;
+}
+
+template <size_t N>
+static char *append_literal(char *out, const char (&text)[N]) {
+  return append_literal(out, text, N - 1);
+}
+
+JsonlRecordWriter::JsonlRecordWriter(const std::string &path)
+    : _path(path), _sink(std::make_unique<UringFileSink>(path)) {}
+
+JsonlRecordWriter::~JsonlRecordWriter() {
+  try {
+    close();
+  } catch (const std::exception &e) {
+    std::cerr << "Error closing " << _path << ": " << e.what() << std::endl;
+  }
+}
+
+void JsonlRecordWriter::write(const char *data, size_t length) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _sink->write(data, length);
+  _bytes_written += length;
+}
+
+void JsonlRecordWriter::close() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _sink->close();
+}
+
+JsonlRecordWriter::Buffer::Buffer(JsonlRecordWriter &writer, size_t capacity)
+    : _writer(writer), _data(capacity), _flush_at(capacity) {}
+
+JsonlRecordWriter::Buffer::~Buffer() {
+  try {
+    flush();
+  } catch (const std::exception &e) {
+    std::cerr << "Error flushing game records: " << e.what() << std::endl;
+  }
+}
+
+void JsonlRecordWriter::Buffer::flush() {
+  if (_size > 0) {
+    _writer.write(_data.data(), _size);
+    _size = 0;
+  }
+}
+
+void JsonlRecordWriter::Buffer::append(const GameRecord &record) {
+  const auto &turns = record.turns();
+  // Worst case: fixed text, a 20-digit game id, 26 hand counts, and up to 3
+  // digits plus a comma per move
+  const size_t max_line = 96 + 2 * 13 * 3 + turns.size() * 4;
+  if (_size + max_line > _flush_at) {
+    flush();
+    if (max_line > _data.size()) {
+      _data.resize(max_line);
+    }
+  }
+
+  char *out = _data.data() + _size;
+  // game_id first: lines arrive in completion order, and the id is the key
+  // shared with the features, the archive and the event log
+  out = append_literal(out, "{\"game_id\":");
+  out = format_uint(out, record.game_id());
+  out = append_literal(out, ",\"deal\":[");
+  for (int player = 0; player < 2; ++player) {
+    const auto hand = record.initial_game().player_hand(player);
+    if (player > 0)
+      *out++ = ',';
+    *out++ = '[';
+    for (int rank = 0; rank < 13; ++rank) {
+      if (rank > 0)
+        *out++ = ',';
+      out = format_uint(out, static_cast<unsigned>(hand[rank]));
+    }
+    *out++ = ']';
+  }
+  out = append_literal(out, "],\"moves\":[");
+  for (size_t i = 0; i < turns.size(); ++i) {
+    if (i > 0)
+      *out++ = ',';
+    out = format_uint(out, static_cast<unsigned>(encodeMove(turns[i].move)));
+  }
+  out = append_literal(out, "],\"winner\":");
+  out = format_uint(out, static_cast<unsigned>(record.game().get_winner()));
+  out = append_literal(out, "}\n");
+  _size = out - _data.data();
+}
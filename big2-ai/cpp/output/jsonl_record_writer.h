@@ -0,0 +1,71 @@
+// jsonl_record_writer.h
+#ifndef JSONL_RECORD_WRITER_H
+#define JSONL_RECORD_WRITER_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "uring_file_sink.h"
+
+class GameRecord;
+
+/**
+ * @brief Appends game records to a JSON Lines file, one game per line:
+ *
+ *   {"game_id":7,"deal":[[...13 counts...],[...13 counts...]],
+ *    "moves":[...],"winner":0}
+ *
+ * `game_id` is the key used by the feature tables, the archive and the
+ * event log; line order is not game order. `deal` holds each player's
+ * starting hand as counts by rank (3..2), and `moves` the encodeMove() id of
+ * every move in order.
+ *
+ * Each worker formats into its own Buffer (no iostreams, no locking) and
+ * hands full buffers to the writer, which copies them into an io_uring
+ * sink under a mutex. Lines from one buffer stay together; lines from
+ * different workers interleave in flush order.
+ */
+class JsonlRecordWriter {
+public:
+  explicit JsonlRecordWriter(const std::string &path);
+  ~JsonlRecordWriter();
+
+  JsonlRecordWriter(const JsonlRecordWriter &) = delete;
+  JsonlRecordWriter &operator=(const JsonlRecordWriter &) = delete;
+
+  /**
+   * @brief Per-thread formatting buffer; flushes to the writer when full
+   * and on destruction.
+   */
+  class Buffer {
+  public:
+    explicit Buffer(JsonlRecordWriter &writer, size_t capacity = 1 << 20);
+    ~Buffer();
+
+    void append(const GameRecord &record);
+    void flush();
+
+  private:
+    JsonlRecordWriter &_writer;
+    std::vector<char> _data;
+    size_t _size = 0;
+    size_t _flush_at;
+  };
+
+  size_t bytes_written() const { return _bytes_written; }
+
+  void close();
+
+private:
+  std::string _path;
+  std::unique_ptr<UringFileSink> _sink;
+  std::mutex _mutex;
+  size_t _bytes_written = 0;
+
+  void write(const char *data, size_t length);
+};
+
+#endif // JSONL_RECORD_WRITER_H
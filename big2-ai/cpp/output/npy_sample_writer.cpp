@@ -0,0 +1,109 @@
+// npy_sample_writer.cpp
+#include "npy_sample_writer.h"
+#include "training_sample_encoder.h"
+
+#include <vector>
+
+using Encoder = TrainingSampleEncoder;
+
+NpySampleWriter::NpySampleWriter(const std::string &prefix,
+                                 size_t reserve_rows)
+    : _state(prefix + "state_samples.npy", "<f4", {Encoder::kStateSize},
+             reserve_rows),
+      _turn(prefix + "turn_samples.npy", "|i1", {}, reserve_rows),
+      _legal_mask(prefix + "legal_mask_samples.npy", "|u1",
+                  {Encoder::kMaskSize}, reserve_rows),
+      _value(prefix + "value_samples.npy", "<f4", {}, reserve_rows),
+      _move(prefix + "move_samples.npy", "<i2", {}, reserve_rows) {}
+
+void NpySampleWriter::write(const GameRecord &record) {
+  // Encode the whole game locally, then write each file in one pwrite
+  thread_local std::vector<float> state;
+  thread_local std::vector<int8_t> turn_head;
+  thread_local std::vector<uint8_t> legal_mask;
+  thread_local std::vector<float> value;
+  thread_local std::vector<int16_t> move;
+
+  size_t rows = 0;
+  for (const auto &turn : record.turns()) {
+    rows += Encoder::has_player_sample(turn);
+    rows += Encoder::has_opponent_sample(turn);
+  }
+  if (rows == 0) {
+    return;
+  }
+  state.resize(rows * Encoder::kStateSize);
+  turn_head.resize(rows);
+  legal_mask.resize(rows * Encoder::kMaskSize);
+  value.resize(rows);
+  move.resize(rows);
+
+  size_t row = 0;
+  auto encode = [&](const TurnRecord &turn, int head) {
+    Encoder::encode_state(turn, head, &state[row * Encoder::kStateSize]);
+    turn_head[row] = static_cast<int8_t>(head);
+    Encoder::encode_legal_mask(turn, head,
+                               &legal_mask[row * Encoder::kMaskSize]);
+    value[row] = Encoder::encode_value(record, turn, head);
+    move[row] = Encoder::encode_move(turn);
+    ++row;
+  };
+  for (const auto &turn : record.turns()) {
+    if (Encoder::has_player_sample(turn)) {
+      encode(turn, Encoder::kPlayerHead);
+    }
+    if (Encoder::has_opponent_sample(turn)) {
+      encode(turn, Encoder::kOpponentHead);
+    }
+  }
+
+  if (_failed.load(std::memory_order_acquire)) {
+    return;
+  }
+  try {
+    size_t first;
+    {
+      std::lock_guard<std::mutex> lock(_reserve_mutex);
+      if (_failed.load(std::memory_order_relaxed)) {
+        return;
+      }
+      // Preallocate every file before claiming rows in any of them, so a
+      // failed fallocate cannot leave their row counts out of step
+      first = _state.rows_written();
+      _state.preallocate(first + rows);
+      _turn.preallocate(first + rows);
+      _legal_mask.preallocate(first + rows);
+      _value.preallocate(first + rows);
+      _move.preallocate(first + rows);
+      _state.reserve(rows);
+      _turn.reserve(rows);
+      _legal_mask.reserve(rows);
+      _value.reserve(rows);
+      _move.reserve(rows);
+    }
+    _state.write(first, state.data(), rows);
+    _turn.write(first, turn_head.data(), rows);
+    _legal_mask.write(first, legal_mask.data(), rows);
+    _value.write(first, value.data(), rows);
+    _move.write(first, move.data(), rows);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(_reserve_mutex);
+    if (!_error) {
+      _error = std::current_exception();
+    }
+    _failed.store(true, std::memory_order_release);
+    throw;
+  }
+}
+
+void NpySampleWriter::close() {
+  _state.close();
+  _turn.close();
+  _legal_mask.close();
+  _value.close();
+  _move.close();
+  std::lock_guard<std::mutex> lock(_reserve_mutex);
+  if (_error) {
+    std::rethrow_exception(_error);
+  }
+}
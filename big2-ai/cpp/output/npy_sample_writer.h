@@ -0,0 +1,63 @@
+// npy_sample_writer.h
+#ifndef NPY_SAMPLE_WRITER_H
+#define NPY_SAMPLE_WRITER_H
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <string>
+
+#include "../game_record.h"
+#include "npy_writer.h"
+
+/**
+ * @brief Streams training samples of finished games into five aligned
+ * `.npy` files that the trainer memory-maps directly:
+ *   <prefix>state_samples.npy       float32 [N, 26]
+ *   <prefix>turn_samples.npy        int8    [N]
+ *   <prefix>legal_mask_samples.npy  uint8   [N, 467]
+ *   <prefix>value_samples.npy       float32 [N]
+ *   <prefix>move_samples.npy        int16   [N]
+ * Names, shapes, sample selection and values are those of the old
+ * trainer's files (see TrainingSampleEncoder); only the integer arrays are
+ * narrower than its int32. Row i of every file describes the same sample.
+ * Workers call write() as each game finishes; a game's rows stay
+ * contiguous, but games appear in completion order.
+ *
+ * The first write error stops all further writes and is rethrown by
+ * close(), so a run never ends with misaligned or zero-filled rows unnoticed.
+ */
+class NpySampleWriter {
+public:
+  /**
+   * @param prefix       Path prefix of the five files (e.g. "data/run1_").
+   * @param reserve_rows Rows to preallocate per file (a hint only).
+   */
+  explicit NpySampleWriter(const std::string &prefix, size_t reserve_rows = 0);
+
+  /**
+   * @brief Encode and write every sample of a finished game. Thread-safe.
+   */
+  void write(const GameRecord &record);
+
+  size_t num_samples() const { return _state.rows_written(); }
+
+  /**
+   * @brief Finalize the headers of all five files. Rethrows the first error
+   * raised by write(), if any.
+   */
+  void close();
+
+private:
+  NpyWriter _state;
+  NpyWriter _turn;
+  NpyWriter _legal_mask;
+  NpyWriter _value;
+  NpyWriter _move;
+  // Keeps the row claims of the five files in step
+  std::mutex _reserve_mutex;
+  std::atomic<bool> _failed{false};
+  std::exception_ptr _error; // guarded by _reserve_mutex
+};
+
+#endif // NPY_SAMPLE_WRITER_H
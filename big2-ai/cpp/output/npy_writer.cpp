@@ -0,0 +1,166 @@
+// npy_writer.cpp
+#include "npy_writer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+static std::runtime_error io_error(const std::string &what,
+                                   const std::string &path) {
+  return std::runtime_error("NpyWriter: " + what + " '" + path +
+                            "': " + std::strerror(errno));
+}
+
+// Bytes per element of a dtype string such as "<f4" or "|u1"
+static size_t dtype_size(const std::string &descr) {
+  if (descr.size() < 3) {
+    throw std::invalid_argument("NpyWriter: bad dtype '" + descr + "'.");
+  }
+  return std::stoul(descr.substr(2));
+}
+
+NpyWriter::NpyWriter(const std::string &path, const std::string &descr,
+                     std::vector<size_t> row_shape, size_t reserve_rows)
+    : _path(path), _descr(descr), _row_shape(std::move(row_shape)),
+      _row_bytes(dtype_size(descr)) {
+  for (size_t dim : _row_shape) {
+    _row_bytes *= dim;
+  }
+  _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (_fd < 0) {
+    throw io_error("cannot open", path);
+  }
+  // Placeholder header; rewritten with the real row count on close()
+  std::string placeholder = header(0);
+  if (::pwrite(_fd, placeholder.data(), placeholder.size(), 0) !=
+      static_cast<ssize_t>(placeholder.size())) {
+    auto error = io_error("cannot write header to", path);
+    ::close(_fd);
+    throw error;
+  }
+  if (reserve_rows > 0) {
+    ensure_allocated(reserve_rows);
+  }
+}
+
+NpyWriter::~NpyWriter() {
+  if (_fd >= 0) {
+    try {
+      close();
+    } catch (const std::exception &e) {
+      std::cerr << "Error closing .npy file: " << e.what() << std::endl;
+    }
+  }
+}
+
+std::string NpyWriter::header(size_t num_rows) const {
+  std::ostringstream dict;
+  dict << "{'descr': '" << _descr << "', 'fortran_order': False, 'shape': ("
+       << num_rows << ",";
+  for (size_t i = 0; i < _row_shape.size(); ++i) {
+    dict << (i == 0 ? " " : ", ") << _row_shape[i];
+  }
+  dict << "), }";
+
+  // Magic, version 1.0, little-endian header length, then the dict padded
+  // with spaces and terminated by a newline to fill the fixed slot
+  std::string text = dict.str();
+  const size_t prefix = 10;
+  if (prefix + text.size() + 1 > kHeaderSize) {
+    throw std::length_error("NpyWriter: header does not fit its slot.");
+  }
+  text.append(kHeaderSize - prefix - text.size() - 1, ' ');
+  text.push_back('\n');
+
+  const uint16_t len = static_cast<uint16_t>(text.size());
+  std::string out("\x93NUMPY\x01\x00", 8);
+  out.push_back(static_cast<char>(len & 0xff));
+  out.push_back(static_cast<char>(len >> 8));
+  return out + text;
+}
+
+void NpyWriter::ensure_allocated(size_t end_row) {
+  if (end_row <= _allocated_rows.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(_grow_mutex);
+  size_t allocated = _allocated_rows.load(std::memory_order_relaxed);
+  if (end_row <= allocated) {
+    return;
+  }
+  // Grow geometrically so the number of fallocate calls stays logarithmic
+  size_t target = std::max({end_row, allocated * 2, kMinGrowRows});
+  int rc = ::posix_fallocate(_fd, static_cast<off_t>(kHeaderSize),
+                             static_cast<off_t>(target * _row_bytes));
+  if (rc != 0 && rc != EOPNOTSUPP && rc != EINVAL) {
+    errno = rc;
+    throw io_error("cannot preallocate", _path);
+  }
+  _allocated_rows.store(target, std::memory_order_release);
+}
+
+size_t NpyWriter::reserve(size_t num_rows) {
+  if (_fd < 0) {
+    throw std::logic_error("NpyWriter: write after close.");
+  }
+  // Allocate before claiming, so a failed fallocate leaves the row count
+  // (and with it the final header) unchanged
+  size_t first = _next_row.load();
+  do {
+    ensure_allocated(first + num_rows);
+  } while (!_next_row.compare_exchange_weak(first, first + num_rows));
+  return first;
+}
+
+void NpyWriter::write(size_t first, const void *data, size_t num_rows) {
+  if (_fd < 0) {
+    throw std::logic_error("NpyWriter: write after close.");
+  }
+
+  const char *src = static_cast<const char *>(data);
+  size_t remaining = num_rows * _row_bytes;
+  off_t offset = static_cast<off_t>(kHeaderSize + first * _row_bytes);
+  while (remaining > 0) {
+    ssize_t n = ::pwrite(_fd, src, remaining, offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      // No progress: retrying would spin forever on a file that cannot grow
+      if (n == 0) {
+        errno = EIO;
+      }
+      throw io_error("cannot write to", _path);
+    }
+    src += n;
+    offset += n;
+    remaining -= static_cast<size_t>(n);
+  }
+}
+
+void NpyWriter::close() {
+  if (_fd < 0) {
+    return;
+  }
+  const int fd = _fd;
+  _fd = -1;
+  const size_t num_rows = _next_row.load();
+  std::string final_header = header(num_rows);
+  bool ok = ::pwrite(fd, final_header.data(), final_header.size(), 0) ==
+                static_cast<ssize_t>(final_header.size()) &&
+            ::ftruncate(fd, static_cast<off_t>(kHeaderSize +
+                                               num_rows * _row_bytes)) == 0;
+  if (!ok) {
+    ::close(fd);
+    throw io_error("cannot finalize", _path);
+  }
+  if (::close(fd) != 0) {
+    throw io_error("cannot close", _path);
+  }
+}
@@ -0,0 +1,90 @@
+// npy_writer.h
+#ifndef NPY_WRITER_H
+#define NPY_WRITER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Streams rows of a fixed-shape array into a NumPy `.npy` file.
+ *
+ * The file starts with a fixed-size header slot; rows are written behind it
+ * with pwrite() as they arrive and the header is filled in with the final
+ * row count on close(). Space is preallocated in growing chunks so long runs
+ * do not fragment the file. Several threads may append concurrently: each
+ * reserves a row range atomically and writes it without further locking.
+ *
+ * The output is a plain version 1.0 `.npy` file that `numpy.load(...,
+ * mmap_mode="r")` maps directly.
+ */
+class NpyWriter {
+public:
+  /**
+   * @param path      Output file (truncated if it exists).
+   * @param descr     NumPy dtype string, e.g. "<f4", "|u1", "<i2".
+   * @param row_shape Shape of one row; empty for a 1-D array of scalars.
+   * @param reserve_rows Rows to preallocate up front (a hint only).
+   */
+  NpyWriter(const std::string &path, const std::string &descr,
+            std::vector<size_t> row_shape, size_t reserve_rows = 0);
+  ~NpyWriter();
+
+  NpyWriter(const NpyWriter &) = delete;
+  NpyWriter &operator=(const NpyWriter &) = delete;
+
+  size_t row_bytes() const { return _row_bytes; }
+  size_t rows_written() const { return _next_row.load(); }
+
+  /**
+   * @brief Claim `num_rows` consecutive rows. Thread-safe. If preallocation
+   * fails, no rows are claimed.
+   * @return Index of the first claimed row.
+   */
+  size_t reserve(size_t num_rows);
+
+  /**
+   * @brief Preallocate space for the first `num_rows` rows. Thread-safe.
+   */
+  void preallocate(size_t num_rows) { ensure_allocated(num_rows); }
+
+  /**
+   * @brief Write rows previously claimed with reserve(). Thread-safe for
+   * disjoint ranges. Every claimed row must be written before close().
+   */
+  void write(size_t first_row, const void *data, size_t num_rows);
+
+  /**
+   * @brief Append `num_rows` rows of `row_bytes()` each. Thread-safe.
+   */
+  void append(const void *data, size_t num_rows) {
+    write(reserve(num_rows), data, num_rows);
+  }
+
+  /**
+   * @brief Write the final header, trim the preallocated tail and close.
+   */
+  void close();
+
+private:
+  static constexpr size_t kHeaderSize = 128;
+  static constexpr size_t kMinGrowRows = 1 << 16;
+
+  std::string _path;
+  std::string _descr;
+  std::vector<size_t> _row_shape;
+  size_t _row_bytes;
+  int _fd = -1;
+
+  std::atomic<size_t> _next_row{0};
+  std::mutex _grow_mutex;
+  std::atomic<size_t> _allocated_rows{0};
+
+  void ensure_allocated(size_t end_row);
+  std::string header(size_t num_rows) const;
+};
+
+#endif // NPY_WRITER_H
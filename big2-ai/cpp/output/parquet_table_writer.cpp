@@ -0,0 +1,105 @@
+// parquet_table_writer.cpp
+#include "parquet_table_writer.h"
+#include "trace_recorder.h"
+#include "uring_output_stream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+#include <arrow/util/byte_size.h>
+#include <parquet/exception.h>
+
+ParquetTableWriter::ParquetTableWriter(const std::string &path,
+                                       std::shared_ptr<arrow::Schema> schema,
+                                       const ParquetWriterConfig &config,
+                                       const std::vector<ColumnSpec> &specs)
+    : _path(path), _row_group_size(config.row_group_size) {
+  if (_row_group_size <= 0) {
+    throw std::invalid_argument("ParquetTableWriter: row_group_size must be "
+                                "positive.");
+  }
+  PARQUET_ASSIGN_OR_THROW(_sink, UringOutputStream::Open(path));
+  PARQUET_ASSIGN_OR_THROW(
+      _writer, parquet::arrow::FileWriter::Open(
+                   *schema, arrow::default_memory_pool(), _sink,
+                   config.properties(*schema, specs),
+                   config.arrow_properties()));
+}
+
+ParquetTableWriter::~ParquetTableWriter() {
+  // Never throw from a destructor; an unclosed file is reported instead
+  if (_writer) {
+    try {
+      close();
+    } catch (const std::exception &e) {
+      std::cerr << "Error closing Parquet file " << _path << ": " << e.what()
+                << std::endl;
+    }
+  }
+}
+
+void ParquetTableWriter::write(const arrow::Table &table) {
+  if (!_writer) {
+    throw std::logic_error("ParquetTableWriter: write after close.");
+  }
+  if (_failed) {
+    throw std::runtime_error("ParquetTableWriter: an earlier write to '" +
+                             _path + "' failed.");
+  }
+  auto start = std::chrono::steady_clock::now();
+  try {
+    // Feature tables have one chunk per column, so this does not copy
+    std::shared_ptr<arrow::RecordBatch> batch;
+    PARQUET_ASSIGN_OR_THROW(batch, table.CombineChunksToBatch());
+    // One buffered row group per slice: only this path encodes the columns
+    // on Arrow's CPU pool when use_threads is set (WriteTable encodes them
+    // one after another). Each row group shows up as its own span in a
+    // trace.
+    for (int64_t offset = 0; offset < batch->num_rows();
+         offset += _row_group_size) {
+      TraceSpan span("write_row_group");
+      PARQUET_THROW_NOT_OK(_writer->NewBufferedRowGroup());
+      PARQUET_THROW_NOT_OK(
+          _writer->WriteRecordBatch(*batch->Slice(offset, _row_group_size)));
+    }
+  } catch (...) {
+    _failed = true;
+    throw;
+  }
+  _encode_seconds += std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+  _rows_written += table.num_rows();
+  _input_bytes += arrow::util::TotalBufferSize(table);
+}
+
+void ParquetTableWriter::close() {
+  if (!_writer) {
+    return;
+  }
+  auto writer = std::move(_writer);
+  if (_failed) {
+    // Close the stream before the FileWriter goes away: its destructor would
+    // otherwise append a footer that makes the incomplete file look valid
+    (void)_sink->Close();
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  PARQUET_THROW_NOT_OK(writer->Close());
+  _encode_seconds += std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+  int64_t file_bytes = 0;
+  PARQUET_ASSIGN_OR_THROW(file_bytes, _sink->Tell());
+  PARQUET_THROW_NOT_OK(_sink->Close());
+
+  // Throughput is measured against the uncompressed Arrow input
+  const double seconds = std::max(_encode_seconds, 1e-9);
+  std::cout << "[Parquet] " << _path << ": " << _rows_written << " rows, "
+            << _input_bytes / 1e6 << " MB -> " << file_bytes / 1e6
+            << " MB in " << _encode_seconds << " s ("
+            << _rows_written / seconds / 1e6 << " M rows/s, "
+            << _input_bytes / seconds / 1e6 << " MB/s)\n";
+}
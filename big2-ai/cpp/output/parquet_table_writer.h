@@ -0,0 +1,60 @@
+// parquet_table_writer.h
+#ifndef PARQUET_TABLE_WRITER_H
+#define PARQUET_TABLE_WRITER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/io/api.h>
+#include <parquet/arrow/writer.h>
+
+#include "parquet_writer_config.h"
+#include "table_writer.h"
+
+/**
+ * @brief Streams tables into a single Parquet file as row groups.
+ *
+ * One parquet::arrow::FileWriter stays open for the whole run; every write()
+ * appends row groups, and close() writes the footer and reports encode
+ * throughput. After a failed write() the file is left without a footer and
+ * every later write() throws.
+ */
+class ParquetTableWriter : public TableWriter {
+public:
+  /**
+   * @param path   Output file (truncated if it exists).
+   * @param schema Schema every appended table must match.
+   * @param config Codec, encodings and row-group size.
+   * @param specs  Column specs of the schema's fields, for encoding hints.
+   */
+  ParquetTableWriter(const std::string &path,
+                     std::shared_ptr<arrow::Schema> schema,
+                     const ParquetWriterConfig &config = {},
+                     const std::vector<ColumnSpec> &specs = {});
+  ~ParquetTableWriter() override;
+
+  void write(const arrow::Table &table) override;
+  void close() override;
+
+  int64_t rows_written() const { return _rows_written; }
+
+  /**
+   * @brief Wall time spent inside WriteTable (encode, compress, write).
+   */
+  double encode_seconds() const { return _encode_seconds; }
+
+private:
+  std::string _path;
+  int64_t _row_group_size;
+  int64_t _rows_written = 0;
+  int64_t _input_bytes = 0;
+  bool _failed = false;
+  double _encode_seconds = 0.0;
+  std::shared_ptr<arrow::io::OutputStream> _sink;
+  std::unique_ptr<parquet::arrow::FileWriter> _writer;
+};
+
+#endif // PARQUET_TABLE_WRITER_H
@@ -0,0 +1,103 @@
+// parquet_writer_config.cpp
+#include "parquet_writer_config.h"
+
+// Parquet leaf path of a top-level field (list values live one level down)
+static std::string leaf_path(const arrow::Field &field) {
+  if (field.type()->id() == arrow::Type::FIXED_SIZE_LIST) {
+    return field.name() + ".list.element";
+  }
+  return field.name();
+}
+
+std::shared_ptr<parquet::WriterProperties>
+ParquetWriterConfig::properties(const arrow::Schema &schema,
+                                const std::vector<ColumnSpec> &specs) const {
+  parquet::WriterProperties::Builder builder;
+  builder.compression(compression);
+  if (compression_level) {
+    builder.compression_level(*compression_level);
+  }
+  if (dictionary) {
+    builder.enable_dictionary();
+  } else {
+    builder.disable_dictionary();
+  }
+  if (statistics) {
+    builder.enable_statistics();
+  } else {
+    builder.disable_statistics();
+  }
+  builder.max_row_group_length(row_group_size);
+
+  for (int i = 0; i < schema.num_fields(); ++i) {
+    const auto &field = *schema.field(i);
+    const std::string path = leaf_path(field);
+    const ColumnSpec spec =
+        i < static_cast<int>(specs.size()) ? specs[i] : ColumnSpec{};
+
+    // Start from the global setting, then apply the feature's hint
+    bool use_dictionary = dictionary;
+    bool use_split = byte_stream_split && spec.type == ColumnType::kFloat32;
+    switch (spec.encoding) {
+    case ColumnEncoding::kDictionary:
+      use_dictionary = true;
+      use_split = false;
+      break;
+    case ColumnEncoding::kPlain:
+      use_dictionary = false;
+      use_split = false;
+      break;
+    case ColumnEncoding::kByteStreamSplit:
+      use_dictionary = false;
+      use_split = spec.type == ColumnType::kFloat32;
+      break;
+    case ColumnEncoding::kDefault:
+      break;
+    }
+
+    // Explicit overrides win
+    auto it = column_overrides.find(field.name());
+    if (it != column_overrides.end()) {
+      const ParquetColumnOptions &options = it->second;
+      if (options.dictionary) {
+        use_dictionary = *options.dictionary;
+      }
+      if (options.byte_stream_split) {
+        use_split = *options.byte_stream_split;
+      }
+      if (options.compression) {
+        builder.compression(path, *options.compression);
+      }
+      if (options.compression_level) {
+        builder.compression_level(path, *options.compression_level);
+      }
+      if (options.statistics) {
+        if (*options.statistics) {
+          builder.enable_statistics(path);
+        } else {
+          builder.disable_statistics(path);
+        }
+      }
+    }
+
+    // Byte-stream-split is a data encoding; it only applies without a
+    // dictionary
+    if (use_split) {
+      use_dictionary = false;
+      builder.encoding(path, parquet::Encoding::BYTE_STREAM_SPLIT);
+    }
+    if (use_dictionary) {
+      builder.enable_dictionary(path);
+    } else {
+      builder.disable_dictionary(path);
+    }
+  }
+  return builder.build();
+}
+
+std::shared_ptr<parquet::ArrowWriterProperties>
+ParquetWriterConfig::arrow_properties() const {
+  parquet::ArrowWriterProperties::Builder builder;
+  builder.set_use_threads(use_threads);
+  return builder.build();
+}
@@ -0,0 +1,64 @@
+// parquet_writer_config.h
+#ifndef PARQUET_WRITER_CONFIG_H
+#define PARQUET_WRITER_CONFIG_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <parquet/properties.h>
+
+#include "column_buffer.h"
+
+/**
+ * @brief Per-column overrides; unset fields fall back to the global setting
+ * or the feature's ColumnEncoding hint.
+ */
+struct ParquetColumnOptions {
+  std::optional<arrow::Compression::type> compression;
+  std::optional<int> compression_level;
+  std::optional<bool> dictionary;
+  std::optional<bool> byte_stream_split;
+  std::optional<bool> statistics;
+};
+
+/**
+ * @brief Parquet writer properties for feature outputs.
+ *
+ * Precedence for every column: column_overrides, then the extractor's
+ * ColumnEncoding hint, then the global fields below.
+ */
+struct ParquetWriterConfig {
+  arrow::Compression::type compression = arrow::Compression::ZSTD;
+  // Codec default when unset
+  std::optional<int> compression_level;
+  bool dictionary = true;
+  // Byte-stream-split applies to float columns only
+  bool byte_stream_split = false;
+  int64_t row_group_size = 1 << 20;
+  bool statistics = true;
+  // Encode and compress the columns of a row group on Arrow's CPU pool.
+  // Off by default, as in Arrow: it only pays off with idle cores, and the
+  // worker threads already keep them busy
+  bool use_threads = false;
+  // Encode on a background thread so the next batch's simulation overlaps
+  // with writing the previous one; shuffled output also shuffles on one
+  bool pipelined = true;
+  std::map<std::string, ParquetColumnOptions> column_overrides;
+
+  /**
+   * @brief Build writer properties for a schema whose columns were declared
+   * with `specs` (one per field, in order; may be empty).
+   */
+  std::shared_ptr<parquet::WriterProperties>
+  properties(const arrow::Schema &schema,
+             const std::vector<ColumnSpec> &specs = {}) const;
+
+  std::shared_ptr<parquet::ArrowWriterProperties> arrow_properties() const;
+};
+
+#endif // PARQUET_WRITER_CONFIG_H
@@ -0,0 +1,107 @@
+// partitioned_dataset_writer.cpp
+#include "partitioned_dataset_writer.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+PartitionedDatasetWriter::PartitionedDatasetWriter(
+    const std::string &root, unsigned int run_id, int num_shards,
+    std::shared_ptr<arrow::Schema> schema, const std::string &extension,
+    const WriterFactory &factory)
+    : _run_id(run_id), _schema(std::move(schema)) {
+  namespace fs = std::filesystem;
+  _run_dir = (fs::path(root) / ("run=" + std::to_string(run_id))).string();
+
+  // Claim the run directory; an existing one belongs to an earlier run
+  // with the same id, whose part files must not be truncated
+  fs::create_directories(root);
+  if (!fs::create_directory(_run_dir)) {
+    throw std::runtime_error("PartitionedDatasetWriter: " + _run_dir +
+                             " already exists; use a new run id.");
+  }
+
+  _shards.resize(num_shards);
+  for (int k = 0; k < num_shards; ++k) {
+    std::string shard_dir = "shard=" + std::to_string(k);
+    fs::create_directories(fs::path(_run_dir) / shard_dir);
+    _shards[k].relative_path = shard_dir + "/part-0." + extension;
+    _shards[k].writer =
+        factory((fs::path(_run_dir) / _shards[k].relative_path).string());
+  }
+}
+
+void PartitionedDatasetWriter::write(int shard, const arrow::Table &table) {
+  Shard &target = _shards.at(shard);
+  if (!target.writer) {
+    throw std::logic_error("PartitionedDatasetWriter: write after close.");
+  }
+  target.writer->write(table);
+  target.rows += table.num_rows();
+}
+
+void PartitionedDatasetWriter::close() {
+  bool was_open = false;
+  for (auto &shard : _shards) {
+    if (shard.writer) {
+      was_open = true;
+      shard.writer->close();
+      shard.writer.reset();
+    }
+  }
+  if (was_open) {
+    write_manifest();
+  }
+}
+
+// Minimal JSON string escaping for names and paths
+static std::string json_string(const std::string &value) {
+  std::string out = "\"";
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out + "\"";
+}
+
+void PartitionedDatasetWriter::write_manifest() const {
+  namespace fs = std::filesystem;
+  std::ofstream out(fs::path(_run_dir) / "_manifest.json");
+  if (!out) {
+    throw std::runtime_error("Could not write manifest in " + _run_dir);
+  }
+
+  int64_t total_rows = 0;
+  for (const auto &shard : _shards) {
+    total_rows += shard.rows;
+  }
+
+  out << "{\n";
+  out << "  \"run\": " << _run_id << ",\n";
+  out << "  \"partitioning\": [\"run\", \"shard\"],\n";
+  out << "  \"num_shards\": " << _shards.size() << ",\n";
+  out << "  \"total_rows\": " << total_rows << ",\n";
+  out << "  \"schema\": [";
+  for (int i = 0; i < _schema->num_fields(); ++i) {
+    const auto &field = _schema->field(i);
+    out << (i ? ", " : "") << "{\"name\": " << json_string(field->name())
+        << ", \"type\": " << json_string(field->type()->ToString()) << "}";
+  }
+  out << "],\n";
+  out << "  \"files\": [\n";
+  for (size_t k = 0; k < _shards.size(); ++k) {
+    out << "    {\"shard\": " << k
+        << ", \"path\": " << json_string(_shards[k].relative_path)
+        << ", \"rows\": " << _shards[k].rows << "}"
+        << (k + 1 < _shards.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n";
+  out << "}\n";
+  // A full disk must not leave a truncated manifest that looks complete
+  out.flush();
+  if (!out) {
+    throw std::runtime_error("Could not write manifest in " + _run_dir);
+  }
+}
@@ -0,0 +1,73 @@
+// partitioned_dataset_writer.h
+#ifndef PARTITIONED_DATASET_WRITER_H
+#define PARTITIONED_DATASET_WRITER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "table_writer.h"
+
+/**
+ * @brief Hive-partitioned dataset with one independent file stream per shard.
+ *
+ * Layout under `root`:
+ *   run=<run_id>/shard=<k>/part-0.<extension>
+ *   run=<run_id>/_manifest.json
+ * Each shard is meant to be owned by exactly one worker thread, so shards
+ * need no locking. A new run only adds its own directory; existing runs are
+ * never rewritten, and opening a run id whose directory already exists
+ * throws. Arrow Dataset readers ignore the underscore-prefixed
+ * manifest and can prune on the run and shard keys.
+ */
+class PartitionedDatasetWriter {
+public:
+  using WriterFactory = TableWriterFactory;
+
+  /**
+   * @param root       Dataset directory (created if missing).
+   * @param run_id     Value of the run= partition key.
+   * @param num_shards Number of shard=<k> partitions.
+   * @param schema     Schema of every shard; recorded in the manifest.
+   * @param extension  File extension of the part files (e.g. "parquet").
+   * @param factory    Opens the writer for one part file.
+   */
+  PartitionedDatasetWriter(const std::string &root, unsigned int run_id,
+                           int num_shards,
+                           std::shared_ptr<arrow::Schema> schema,
+                           const std::string &extension,
+                           const WriterFactory &factory);
+
+  int num_shards() const { return static_cast<int>(_shards.size()); }
+
+  /**
+   * @brief Append a table to shard k. Only shard k's owner may call this.
+   */
+  void write(int shard, const arrow::Table &table);
+
+  /**
+   * @brief Close every shard and write the manifest.
+   */
+  void close();
+
+  const std::string &run_dir() const { return _run_dir; }
+
+private:
+  struct Shard {
+    std::string relative_path;
+    std::unique_ptr<TableWriter> writer;
+    int64_t rows = 0;
+  };
+
+  std::string _run_dir;
+  unsigned int _run_id;
+  std::shared_ptr<arrow::Schema> _schema;
+  std::vector<Shard> _shards;
+
+  void write_manifest() const;
+};
+
+#endif // PARTITIONED_DATASET_WRITER_H
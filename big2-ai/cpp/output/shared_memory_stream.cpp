@@ -0,0 +1,89 @@
+// shared_memory_stream.cpp
+#include "shared_memory_stream.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static arrow::Status errno_status(const std::string &what,
+                                  const std::string &name) {
+  return arrow::Status::IOError(what, " '", name, "': ", std::strerror(errno));
+}
+
+arrow::Result<std::shared_ptr<SharedMemoryOutputStream>>
+SharedMemoryOutputStream::Open(const std::string &name,
+                               int64_t initial_capacity) {
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+  if (fd < 0) {
+    return errno_status("shm_open failed for", name);
+  }
+  std::shared_ptr<SharedMemoryOutputStream> stream(
+      new SharedMemoryOutputStream(name, fd));
+  ARROW_RETURN_NOT_OK(stream->Reserve(initial_capacity));
+  return stream;
+}
+
+SharedMemoryOutputStream::SharedMemoryOutputStream(std::string name, int fd)
+    : _name(std::move(name)), _fd(fd) {}
+
+SharedMemoryOutputStream::~SharedMemoryOutputStream() {
+  if (!closed()) {
+    (void)Close();
+  }
+}
+
+arrow::Status SharedMemoryOutputStream::Reserve(int64_t capacity) {
+  if (capacity <= _capacity) {
+    return arrow::Status::OK();
+  }
+  if (ftruncate(_fd, capacity) != 0) {
+    return errno_status("ftruncate failed for", _name);
+  }
+  void *mapped =
+      _data == nullptr
+          ? mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0)
+          : mremap(_data, _capacity, capacity, MREMAP_MAYMOVE);
+  if (mapped == MAP_FAILED) {
+    return errno_status("mmap failed for", _name);
+  }
+  _data = static_cast<uint8_t *>(mapped);
+  _capacity = capacity;
+  return arrow::Status::OK();
+}
+
+arrow::Status SharedMemoryOutputStream::Write(const void *data,
+                                              int64_t nbytes) {
+  if (closed()) {
+    return arrow::Status::Invalid("Write to closed shared memory stream");
+  }
+  if (_size + nbytes > _capacity) {
+    // Grow geometrically so appends stay amortized O(1)
+    ARROW_RETURN_NOT_OK(
+        Reserve(std::max(_size + nbytes, _capacity + _capacity / 2)));
+  }
+  std::memcpy(_data + _size, data, nbytes);
+  _size += nbytes;
+  return arrow::Status::OK();
+}
+
+arrow::Status SharedMemoryOutputStream::Close() {
+  if (closed()) {
+    return arrow::Status::OK();
+  }
+  if (_data != nullptr) {
+    munmap(_data, _capacity);
+    _data = nullptr;
+  }
+  // Drop the unused tail so readers see exactly the written bytes
+  int rc = ftruncate(_fd, _size);
+  close(_fd);
+  _fd = -1;
+  if (rc != 0) {
+    return errno_status("ftruncate failed for", _name);
+  }
+  return arrow::Status::OK();
+}
@@ -0,0 +1,46 @@
+// shared_memory_stream.h
+#ifndef SHARED_MEMORY_STREAM_H
+#define SHARED_MEMORY_STREAM_H
+
+#include <cstdint>
+#include <string>
+
+#include <arrow/io/interfaces.h>
+#include <arrow/result.h>
+
+/**
+ * @brief Arrow output stream backed by a POSIX shared-memory segment.
+ *
+ * The segment (shm_open name, e.g. "/big2_turn_features") grows as data is
+ * written and is truncated to the written size on Close(). It outlives the
+ * process so a consumer can map it, e.g. from Python:
+ *   pyarrow.ipc.open_file(pyarrow.memory_map("/dev/shm/big2_turn_features"))
+ * The consumer is responsible for unlinking it.
+ */
+class SharedMemoryOutputStream : public arrow::io::OutputStream {
+public:
+  static arrow::Result<std::shared_ptr<SharedMemoryOutputStream>>
+  Open(const std::string &name, int64_t initial_capacity = 64 << 20);
+
+  ~SharedMemoryOutputStream() override;
+
+  arrow::Status Close() override;
+  bool closed() const override { return _fd < 0; }
+  arrow::Result<int64_t> Tell() const override { return _size; }
+  arrow::Status Write(const void *data, int64_t nbytes) override;
+
+  const std::string &name() const { return _name; }
+
+private:
+  SharedMemoryOutputStream(std::string name, int fd);
+
+  arrow::Status Reserve(int64_t capacity);
+
+  std::string _name;
+  int _fd;
+  uint8_t *_data = nullptr;
+  int64_t _size = 0;
+  int64_t _capacity = 0;
+};
+
+#endif // SHARED_MEMORY_STREAM_H
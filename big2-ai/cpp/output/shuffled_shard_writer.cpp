@@ -0,0 +1,146 @@
+// shuffled_shard_writer.cpp
+#include "shuffled_shard_writer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+#include <arrow/util/bit_util.h>
+
+ShuffledShardWriter::ShuffledShardWriter(const std::string &path,
+                                         std::shared_ptr<arrow::Schema> schema,
+                                         std::vector<ColumnSpec> columns,
+                                         const ShuffleConfig &config,
+                                         TableWriterFactory factory)
+    : _schema(std::move(schema)), _config(config),
+      _factory(std::move(factory)), _rng(config.seed) {
+  if (_config.shard_rows == 0 || _config.buffer_rows < _config.shard_rows) {
+    throw std::invalid_argument(
+        "ShuffleConfig: need 0 < shard_rows <= buffer_rows.");
+  }
+  if (columns.size() != static_cast<size_t>(_schema->num_fields())) {
+    throw std::invalid_argument(
+        "ShuffledShardWriter: column specs do not match the schema.");
+  }
+  std::filesystem::path p(path);
+  _extension = p.extension().string();
+  _stem = (p.parent_path() / p.stem()).string();
+
+  for (const auto &spec : columns) {
+    BufferedColumn column{spec, static_cast<size_t>(column_type_width(
+                                    spec.type) * spec.list_size),
+                          {}};
+    column.data.resize(_config.buffer_rows * column.row_bytes);
+    _columns.push_back(std::move(column));
+  }
+}
+
+ShuffledShardWriter::~ShuffledShardWriter() {
+  if (!_closed) {
+    try {
+      close();
+    } catch (const std::exception &e) {
+      std::cerr << "Error closing shuffled shards: " << e.what() << std::endl;
+    }
+  }
+}
+
+std::string ShuffledShardWriter::shard_path(size_t shard) const {
+  char index[16];
+  std::snprintf(index, sizeof(index), "-%05zu", shard);
+  return _stem + index + _extension;
+}
+
+void ShuffledShardWriter::write(const arrow::Table &table) {
+  if (_closed) {
+    throw std::logic_error("ShuffledShardWriter: write after close.");
+  }
+  // Feed the table in slices that never overfill the buffer; a shard is drawn
+  // every time it fills up.
+  int64_t offset = 0;
+  while (offset < table.num_rows()) {
+    int64_t space = static_cast<int64_t>(_config.buffer_rows - _buffered_rows);
+    int64_t take = std::min(space, table.num_rows() - offset);
+    append_rows(*table.Slice(offset, take));
+    offset += take;
+    if (_buffered_rows == _config.buffer_rows) {
+      emit_shard(_config.shard_rows);
+    }
+  }
+}
+
+void ShuffledShardWriter::append_rows(const arrow::Table &table) {
+  for (size_t c = 0; c < _columns.size(); ++c) {
+    BufferedColumn &column = _columns[c];
+    const int width = column_type_width(column.spec.type);
+    uint8_t *dest = column.data.data() + _buffered_rows * column.row_bytes;
+
+    for (const auto &chunk : table.column(static_cast<int>(c))->chunks()) {
+      // Fixed-size lists are copied through their flat child values
+      const arrow::ArrayData *values = chunk->data().get();
+      int64_t first = values->offset;
+      int64_t count = chunk->length();
+      if (column.spec.list_size > 1) {
+        values = values->child_data[0].get();
+        first = values->offset + first * column.spec.list_size;
+        count *= column.spec.list_size;
+      }
+      const uint8_t *src = values->buffers[1]->data();
+      if (column.spec.type == ColumnType::kBool) {
+        for (int64_t i = 0; i < count; ++i) {
+          dest[i] = arrow::bit_util::GetBit(src, first + i);
+        }
+      } else {
+        std::memcpy(dest, src + first * width, count * width);
+      }
+      dest += count * width;
+    }
+  }
+  _buffered_rows += table.num_rows();
+}
+
+void ShuffledShardWriter::emit_shard(size_t num_rows) {
+  std::vector<ColumnBuffer> out;
+  out.reserve(_columns.size());
+  for (const auto &column : _columns) {
+    out.emplace_back(column.spec, num_rows);
+  }
+
+  // Draw without replacement: copy a random buffered row out, then move the
+  // last buffered row into its slot
+  for (size_t i = 0; i < num_rows; ++i) {
+    std::uniform_int_distribution<size_t> pick(0, _buffered_rows - 1);
+    const size_t j = pick(_rng);
+    const size_t last = --_buffered_rows;
+    for (size_t c = 0; c < _columns.size(); ++c) {
+      BufferedColumn &column = _columns[c];
+      const size_t n = column.row_bytes;
+      uint8_t *row = column.data.data() + j * n;
+      std::memcpy(out[c].data() + i * n, row, n);
+      std::memcpy(row, column.data.data() + last * n, n);
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::Array>> arrays;
+  for (auto &buffer : out) {
+    arrays.push_back(buffer.Finish());
+  }
+  auto table =
+      arrow::Table::Make(_schema, arrays, static_cast<int64_t>(num_rows));
+  auto writer = _factory(shard_path(_next_shard++));
+  writer->write(*table);
+  writer->close();
+}
+
+void ShuffledShardWriter::close() {
+  if (_closed) {
+    return;
+  }
+  _closed = true;
+  while (_buffered_rows > 0) {
+    emit_shard(std::min(_config.shard_rows, _buffered_rows));
+  }
+  _columns.clear();
+}
@@ -0,0 +1,85 @@
+// shuffled_shard_writer.h
+#ifndef SHUFFLED_SHARD_WRITER_H
+#define SHUFFLED_SHARD_WRITER_H
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "column_buffer.h"
+#include "table_writer.h"
+
+/**
+ * @brief Sizing and seed of the shuffle stage.
+ */
+struct ShuffleConfig {
+  bool enabled = false;
+  // Rows held back for mixing; larger buffers mix across more games
+  size_t buffer_rows = size_t{1} << 22;
+  // Rows per emitted shard file (the last shard may be shorter)
+  size_t shard_rows = size_t{1} << 20;
+  uint64_t seed = 0;
+};
+
+/**
+ * @brief Mixes incoming rows through a bounded shuffle buffer and writes them
+ * out as fixed-size shards.
+ *
+ * Rows are held in a buffer of up to `buffer_rows`. Whenever it fills, a
+ * shard of `shard_rows` rows is drawn uniformly at random without
+ * replacement and written to `<stem>-<k>.<ext>`; close() drains the rest the
+ * same way. Consecutive rows of a shard therefore come from many different
+ * games, and the output is deterministic for a given input order and seed.
+ */
+class ShuffledShardWriter : public TableWriter {
+public:
+  /**
+   * @param path    Output path; shard k is written next to it as
+   *                `<stem>-<k, 5 digits><extension>`.
+   * @param schema  Schema of the incoming tables.
+   * @param columns Column specs matching `schema`.
+   * @param config  Buffer size, shard size and seed.
+   * @param factory Opens the writer for one shard file.
+   */
+  ShuffledShardWriter(const std::string &path,
+                      std::shared_ptr<arrow::Schema> schema,
+                      std::vector<ColumnSpec> columns,
+                      const ShuffleConfig &config,
+                      TableWriterFactory factory);
+  ~ShuffledShardWriter() override;
+
+  void write(const arrow::Table &table) override;
+  void close() override;
+
+  size_t num_shards() const { return _next_shard; }
+
+private:
+  // One column of buffered rows; booleans are unpacked to one byte per value
+  struct BufferedColumn {
+    ColumnSpec spec;
+    size_t row_bytes;
+    std::vector<uint8_t> data;
+  };
+
+  std::string _stem;
+  std::string _extension;
+  std::shared_ptr<arrow::Schema> _schema;
+  ShuffleConfig _config;
+  TableWriterFactory _factory;
+  std::mt19937_64 _rng;
+
+  std::vector<BufferedColumn> _columns;
+  size_t _buffered_rows = 0;
+  size_t _next_shard = 0;
+  bool _closed = false;
+
+  void append_rows(const arrow::Table &table);
+  void emit_shard(size_t num_rows);
+  std::string shard_path(size_t shard) const;
+};
+
+#endif // SHUFFLED_SHARD_WRITER_H
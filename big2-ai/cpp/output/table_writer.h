@@ -0,0 +1,39 @@
+// table_writer.h
+#ifndef TABLE_WRITER_H
+#define TABLE_WRITER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+/**
+ * @brief Long-lived sink for feature tables.
+ *
+ * The coordinator opens one writer per output before simulation starts and
+ * appends each batch as soon as it is extracted, so nothing is staged in
+ * temporary files or concatenated afterwards.
+ */
+class TableWriter {
+public:
+  virtual ~TableWriter() = default;
+
+  /**
+   * @brief Append a table whose schema matches the writer's schema.
+   */
+  virtual void write(const arrow::Table &table) = 0;
+
+  /**
+   * @brief Flush and finalize the output. No writes are allowed afterwards.
+   */
+  virtual void close() = 0;
+};
+
+/**
+ * @brief Opens the writer for one output file.
+ */
+using TableWriterFactory =
+    std::function<std::unique_ptr<TableWriter>(const std::string &path)>;
+
+#endif // TABLE_WRITER_H
@@ -0,0 +1,408 @@
+// uring_file_sink.cpp
+#include "uring_file_sink.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static std::runtime_error sys_error(const std::string &what) {
+  return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+struct Completion {
+  unsigned slot;
+  int64_t result; // bytes written or -errno
+};
+
+class UringFileSink::Queue {
+public:
+  virtual ~Queue() = default;
+  virtual bool is_io_uring() const = 0;
+  virtual void submit(unsigned slot, const char *data, size_t length,
+                      int64_t offset) = 0;
+  // Blocks until one submitted write completes
+  virtual Completion wait() = 0;
+};
+
+// ---------------------------------------------------------------- io_uring
+
+// Whether the kernel behind `ring_fd` implements IORING_OP_WRITE. Kernels
+// 5.1-5.5 set up rings but fail every such write with -EINVAL; they also
+// lack IORING_REGISTER_PROBE, so a failed probe means no support
+static bool supports_write(int ring_fd) {
+  constexpr unsigned kOps = IORING_OP_WRITE + 1;
+  std::vector<char> buffer(sizeof(io_uring_probe) +
+                           kOps * sizeof(io_uring_probe_op));
+  auto *probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+  if (::syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE,
+                probe, kOps) < 0) {
+    return false;
+  }
+  return probe->last_op >= IORING_OP_WRITE &&
+         (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+}
+
+/**
+ * Minimal io_uring driver on the raw syscalls: one submission per write,
+ * completions reaped one at a time. Requires IORING_OP_WRITE (Linux 5.6),
+ * which the constructor probes for.
+ */
+class IoUringQueue : public UringFileSink::Queue {
+public:
+  IoUringQueue(int fd, unsigned entries) : _fd(fd) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    _ring_fd = static_cast<int>(
+        ::syscall(__NR_io_uring_setup, entries, &params));
+    if (_ring_fd < 0) {
+      throw sys_error("io_uring_setup");
+    }
+    if (!supports_write(_ring_fd)) {
+      ::close(_ring_fd);
+      throw std::runtime_error("io_uring: IORING_OP_WRITE not supported");
+    }
+
+    _sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cq_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+      _sq_size = _cq_size = std::max(_sq_size, _cq_size);
+    }
+    _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    try {
+      _sq_ring = map(_sq_size, IORING_OFF_SQ_RING);
+      _cq_ring = single_mmap ? _sq_ring : map(_cq_size, IORING_OFF_CQ_RING);
+      _sqes = static_cast<io_uring_sqe *>(map(_sqes_size, IORING_OFF_SQES));
+    } catch (...) {
+      release();
+      throw;
+    }
+
+    char *sq = static_cast<char *>(_sq_ring);
+    _sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    _sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    _sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    char *cq = static_cast<char *>(_cq_ring);
+    _cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    _cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+  }
+
+  ~IoUringQueue() override { release(); }
+
+  bool is_io_uring() const override { return true; }
+
+  void submit(unsigned slot, const char *data, size_t length,
+              int64_t offset) override {
+    // Only this thread advances the SQ tail
+    const unsigned tail = *_sq_tail;
+    const unsigned index = tail & _sq_mask;
+    io_uring_sqe *sqe = &_sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = _fd;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = static_cast<uint32_t>(length);
+    sqe->off = static_cast<uint64_t>(offset);
+    sqe->user_data = slot;
+    _sq_array[index] = index;
+    __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    while (enter(1, 0, 0) < 0) {
+      if (errno != EINTR)
+        throw sys_error("io_uring_enter");
+    }
+  }
+
+  Completion wait() override {
+    while (true) {
+      const unsigned head = *_cq_head;
+      if (head != __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+        const io_uring_cqe &cqe = _cqes[head & _cq_mask];
+        Completion completion{static_cast<unsigned>(cqe.user_data),
+                              cqe.res};
+        __atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+        return completion;
+      }
+      if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+        throw sys_error("io_uring_enter");
+      }
+    }
+  }
+
+private:
+  int _fd;
+  int _ring_fd = -1;
+  void *_sq_ring = nullptr;
+  void *_cq_ring = nullptr;
+  io_uring_sqe *_sqes = nullptr;
+  size_t _sq_size = 0, _cq_size = 0, _sqes_size = 0;
+  unsigned *_sq_tail, *_sq_array, _sq_mask;
+  unsigned *_cq_head, *_cq_tail, _cq_mask;
+  io_uring_cqe *_cqes;
+
+  void *map(size_t size, off_t offset) {
+    void *ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, _ring_fd, offset);
+    if (ptr == MAP_FAILED) {
+      throw sys_error("io_uring mmap");
+    }
+    return ptr;
+  }
+
+  void release() {
+    if (_sqes)
+      ::munmap(_sqes, _sqes_size);
+    if (_cq_ring && _cq_ring != _sq_ring)
+      ::munmap(_cq_ring, _cq_size);
+    if (_sq_ring)
+      ::munmap(_sq_ring, _sq_size);
+    ::close(_ring_fd);
+  }
+
+  int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, _ring_fd,
+                                      to_submit, min_complete, flags,
+                                      nullptr, 0));
+  }
+};
+
+// ---------------------------------------------------------------- fallback
+
+/**
+ * Same contract with a background thread issuing pwrite().
+ */
+class PwriteThreadQueue : public UringFileSink::Queue {
+public:
+  explicit PwriteThreadQueue(int fd)
+      : _fd(fd), _thread(&PwriteThreadQueue::run, this) {}
+
+  ~PwriteThreadQueue() override {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stopping = true;
+    }
+    _changed.notify_all();
+    _thread.join();
+  }
+
+  bool is_io_uring() const override { return false; }
+
+  void submit(unsigned slot, const char *data, size_t length,
+              int64_t offset) override {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _requests.push_back(Request{slot, data, length, offset});
+    _changed.notify_all();
+  }
+
+  Completion wait() override {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _changed.wait(lock, [&] { return !_completions.empty(); });
+    Completion completion = _completions.front();
+    _completions.pop_front();
+    return completion;
+  }
+
+private:
+  struct Request {
+    unsigned slot;
+    const char *data;
+    size_t length;
+    int64_t offset;
+  };
+
+  int _fd;
+  std::mutex _mutex;
+  std::condition_variable _changed;
+  std::deque<Request> _requests;
+  std::deque<Completion> _completions;
+  bool _stopping = false;
+  std::thread _thread;
+
+  void run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+      _changed.wait(lock, [&] { return !_requests.empty() || _stopping; });
+      if (_requests.empty()) {
+        return;
+      }
+      Request request = _requests.front();
+      _requests.pop_front();
+      lock.unlock();
+      ssize_t n;
+      do {
+        n = ::pwrite(_fd, request.data, request.length, request.offset);
+      } while (n < 0 && errno == EINTR);
+      lock.lock();
+      _completions.push_back(Completion{request.slot, n < 0 ? -errno : n});
+      _changed.notify_all();
+    }
+  }
+};
+
+// ---------------------------------------------------------------- sink
+
+UringFileSink::UringFileSink(const std::string &path, size_t buffer_size,
+                             unsigned queue_depth, bool allow_io_uring)
+    : _path(path) {
+  queue_depth = std::max(queue_depth, 1u);
+  _fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (_fd < 0) {
+    throw sys_error("cannot open '" + path + "'");
+  }
+  if (allow_io_uring) {
+    try {
+      _queue = std::make_unique<IoUringQueue>(_fd, queue_depth);
+    } catch (const std::exception &) {
+    }
+  }
+  if (!_queue) {
+    _queue = std::make_unique<PwriteThreadQueue>(_fd);
+  }
+  _slots.resize(queue_depth);
+  for (unsigned i = 0; i < queue_depth; ++i) {
+    _slots[i].data.resize(std::max<size_t>(buffer_size, 4096));
+    _free.push_back(queue_depth - 1 - i);
+  }
+}
+
+UringFileSink::~UringFileSink() {
+  if (_fd >= 0) {
+    try {
+      close();
+    } catch (const std::exception &e) {
+      std::cerr << "Error closing " << _path << ": " << e.what() << std::endl;
+    }
+  }
+}
+
+bool UringFileSink::uses_io_uring() const { return _queue->is_io_uring(); }
+
+void UringFileSink::rethrow_error() const {
+  // Sticky: a failed buffer leaves a hole in the file, so nothing written
+  // after it can be trusted either
+  if (_error) {
+    std::rethrow_exception(_error);
+  }
+}
+
+int64_t UringFileSink::tell() const {
+  rethrow_error();
+  return _position;
+}
+
+void UringFileSink::submit(unsigned slot) {
+  Slot &s = _slots[slot];
+  s.in_flight = true;
+  ++_in_flight;
+  _queue->submit(slot, s.data.data() + s.written, s.size - s.written,
+                 s.offset + static_cast<int64_t>(s.written));
+}
+
+void UringFileSink::reap_one() {
+  Completion completion = _queue->wait();
+  Slot &s = _slots[completion.slot];
+  --_in_flight;
+  s.in_flight = false;
+  if (completion.result < 0) {
+    errno = static_cast<int>(-completion.result);
+    if (!_error) {
+      _error = std::make_exception_ptr(
+          sys_error("cannot write '" + _path + "'"));
+    }
+  } else if (completion.result == 0 && s.written < s.size) {
+    // No progress on a non-empty write; retrying would spin forever and
+    // dropping the rest would truncate the file
+    if (!_error) {
+      _error = std::make_exception_ptr(std::runtime_error(
+          "cannot write '" + _path + "': no bytes written"));
+    }
+  } else {
+    s.written += static_cast<size_t>(completion.result);
+    if (s.written < s.size) {
+      // Short write: queue the remainder of the same buffer
+      submit(completion.slot);
+      return;
+    }
+  }
+  s.size = 0;
+  s.written = 0;
+  _free.push_back(completion.slot);
+}
+
+void UringFileSink::write(const void *data, size_t length) {
+  if (_fd < 0) {
+    throw std::logic_error("UringFileSink: write after close.");
+  }
+  rethrow_error();
+  const char *src = static_cast<const char *>(data);
+  while (length > 0) {
+    if (_current < 0) {
+      while (_free.empty()) {
+        reap_one();
+      }
+      _current = static_cast<int>(_free.back());
+      _free.pop_back();
+      _slots[_current].offset = _position;
+    }
+    Slot &slot = _slots[_current];
+    size_t n = std::min(length, slot.data.size() - slot.size);
+    std::memcpy(slot.data.data() + slot.size, src, n);
+    slot.size += n;
+    _position += static_cast<int64_t>(n);
+    src += n;
+    length -= n;
+    if (slot.size == slot.data.size()) {
+      submit(static_cast<unsigned>(_current));
+      _current = -1;
+    }
+  }
+}
+
+void UringFileSink::flush() {
+  if (_current >= 0 && _slots[_current].size > 0) {
+    submit(static_cast<unsigned>(_current));
+    _current = -1;
+  }
+  while (_in_flight > 0) {
+    reap_one();
+  }
+  rethrow_error();
+}
+
+void UringFileSink::close() {
+  if (_fd < 0) {
+    rethrow_error();
+    return;
+  }
+  std::exception_ptr error;
+  try {
+    flush();
+  } catch (...) {
+    error = std::current_exception();
+  }
+  _queue.reset();
+  const int fd = _fd;
+  _fd = -1;
+  if (::close(fd) != 0 && !error) {
+    throw sys_error("cannot close '" + _path + "'");
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
@@ -0,0 +1,82 @@
+// uring_file_sink.h
+#ifndef URING_FILE_SINK_H
+#define URING_FILE_SINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Append-only file sink that writes through io_uring.
+ *
+ * write() copies into one of `queue_depth` fixed buffers; a full buffer is
+ * submitted as an asynchronous write at its file offset and the producer
+ * carries on with the next free buffer. The producer only waits when every
+ * buffer is in flight. Where io_uring is unavailable (old kernel, no
+ * IORING_OP_WRITE before Linux 5.6, seccomp) the same buffers are written by
+ * a background pwrite() thread.
+ *
+ * Not thread-safe: one producer per sink. A write error is sticky: every
+ * later write(), flush(), tell() and close() rethrows it.
+ */
+class UringFileSink {
+public:
+  /**
+   * @param allow_io_uring false always uses the pwrite() thread.
+   */
+  UringFileSink(const std::string &path, size_t buffer_size = 1 << 20,
+                unsigned queue_depth = 8, bool allow_io_uring = true);
+  ~UringFileSink();
+
+  UringFileSink(const UringFileSink &) = delete;
+  UringFileSink &operator=(const UringFileSink &) = delete;
+
+  void write(const void *data, size_t length);
+
+  /**
+   * @brief Submit the partially filled buffer and wait for all writes.
+   */
+  void flush();
+
+  void close();
+
+  bool closed() const { return _fd < 0; }
+
+  /**
+   * @brief Bytes accepted so far (the logical file position).
+   */
+  int64_t tell() const;
+
+  bool uses_io_uring() const;
+
+  // Submission/completion backend (io_uring or pwrite thread)
+  class Queue;
+
+private:
+  struct Slot {
+    std::vector<char> data;
+    size_t size = 0;
+    size_t written = 0;
+    int64_t offset = 0;
+    bool in_flight = false;
+  };
+
+  std::string _path;
+  int _fd = -1;
+  std::unique_ptr<Queue> _queue;
+  std::vector<Slot> _slots;
+  std::vector<unsigned> _free;
+  int _current = -1;
+  unsigned _in_flight = 0;
+  int64_t _position = 0;
+  std::exception_ptr _error;
+
+  void submit(unsigned slot);
+  void reap_one();
+  void rethrow_error() const;
+};
+
+#endif // URING_FILE_SINK_H
@@ -0,0 +1,46 @@
+// uring_output_stream.cpp
+#include "uring_output_stream.h"
+
+arrow::Result<std::shared_ptr<UringOutputStream>>
+UringOutputStream::Open(const std::string &path) {
+  try {
+    return std::shared_ptr<UringOutputStream>(new UringOutputStream(path));
+  } catch (const std::exception &e) {
+    return arrow::Status::IOError(e.what());
+  }
+}
+
+arrow::Status UringOutputStream::Write(const void *data, int64_t nbytes) {
+  try {
+    _sink.write(data, static_cast<size_t>(nbytes));
+  } catch (const std::exception &e) {
+    return arrow::Status::IOError(e.what());
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Result<int64_t> UringOutputStream::Tell() const {
+  try {
+    return _sink.tell();
+  } catch (const std::exception &e) {
+    return arrow::Status::IOError(e.what());
+  }
+}
+
+arrow::Status UringOutputStream::Flush() {
+  try {
+    _sink.flush();
+  } catch (const std::exception &e) {
+    return arrow::Status::IOError(e.what());
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status UringOutputStream::Close() {
+  try {
+    _sink.close();
+  } catch (const std::exception &e) {
+    return arrow::Status::IOError(e.what());
+  }
+  return arrow::Status::OK();
+}
@@ -0,0 +1,37 @@
+// uring_output_stream.h
+#ifndef URING_OUTPUT_STREAM_H
+#define URING_OUTPUT_STREAM_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <arrow/io/interfaces.h>
+#include <arrow/result.h>
+
+#include "uring_file_sink.h"
+
+/**
+ * @brief Arrow output stream over a UringFileSink, so Parquet and IPC
+ * writers hand their pages to the kernel without waiting for the disk.
+ */
+class UringOutputStream : public arrow::io::OutputStream {
+public:
+  static arrow::Result<std::shared_ptr<UringOutputStream>>
+  Open(const std::string &path);
+
+  arrow::Status Close() override;
+  bool closed() const override { return _sink.closed(); }
+  arrow::Result<int64_t> Tell() const override;
+  arrow::Status Write(const void *data, int64_t nbytes) override;
+  arrow::Status Flush() override;
+
+  using arrow::io::OutputStream::Write;
+
+private:
+  explicit UringOutputStream(const std::string &path) : _sink(path) {}
+
+  UringFileSink _sink;
+};
+
+#endif // URING_OUTPUT_STREAM_H
@@ -1,4 +1,5 @@
 #include "partial_game.h"
+#include "perf_profiler.h"
 #include "util.h"  // for encodeMove and MOVE_TO_CARDS
 #include <iomanip> // For std::setw
 #include <iostream>
@@ -55,9 +56,10 @@ void PartialGame::apply_move(const Move &move) {
   turn = !turn;
 }
 
-std::vector<int> PartialGame::get_legal_moves() const {
-  std::vector<int> legal_moves;
-  legal_moves.reserve(32);
+template <typename Out>
+void PartialGame::collect_legal_moves(Out &legal_moves) const {
+  BIG2_PERF_REGION(kLegalMoves);
+  legal_moves.reserve(legal_moves.size() + 32);
   // We can pass if it's not a new trick (a.k.a. the last move was a pass)
   if (last_move_.combination != Move::Combination::kPass) {
     legal_moves.push_back(kPASS);
@@ -88,12 +90,22 @@ std::vector<int> PartialGame::get_legal_moves() const {
     if (is_legal)
       legal_moves.push_back(move_id);
   }
+}
+
+std::vector<int> PartialGame::get_legal_moves() const {
+  std::vector<int> legal_moves;
+  collect_legal_moves(legal_moves);
   return legal_moves;
 }
 
-std::vector<int> PartialGame::get_possible_moves() const {
-  std::vector<int> possible_moves;
-  possible_moves.reserve(32);
+void PartialGame::get_legal_moves(std::pmr::vector<int> &out) const {
+  collect_legal_moves(out);
+}
+
+template <typename Out>
+void PartialGame::collect_possible_moves(Out &possible_moves) const {
+  BIG2_PERF_REGION(kPossibleMoves);
+  possible_moves.reserve(possible_moves.size() + 32);
   // We can pass if it's not a new trick (a.k.a. the last move was a pass)
   if (last_move_.combination != Move::Combination::kPass) {
     possible_moves.push_back(kPASS);
@@ -132,9 +144,18 @@ std::vector<int> PartialGame::get_possible_moves() const {
     if (is_legal)
       possible_moves.push_back(move_id);
   }
+}
+
+std::vector<int> PartialGame::get_possible_moves() const {
+  std::vector<int> possible_moves;
+  collect_possible_moves(possible_moves);
   return possible_moves;
 }
 
+void PartialGame::get_possible_moves(std::pmr::vector<int> &out) const {
+  collect_possible_moves(out);
+}
+
 std::ostream &operator<<(std::ostream &os, const PartialGame &g) {
   os << "--- PartialGame State ---\n";
   os << "Turn: " << (g.turn == 0 ? "Player" : "Opponent") << "\n";
@@ -4,6 +4,7 @@
 #include "game.h"
 #include "move.h" // Represents a single play (type, rank, length, etc.)
 #include <array>
+#include <memory_resource>
 #include <vector>
 
 /**
@@ -31,6 +32,10 @@ public:
   std::vector<int> get_legal_moves() const;
   std::vector<int> get_possible_moves() const;
 
+  // Append the same move ids to `out`, e.g. an arena-backed vector
+  void get_legal_moves(std::pmr::vector<int> &out) const;
+  void get_possible_moves(std::pmr::vector<int> &out) const;
+
   std::array<int, 13> player_hand() const { return player_hand_; }
 
 private:
@@ -40,6 +45,10 @@ private:
   std::array<int, 13> discard_pile_{}; // Cards played so far (by rank)
   Move last_move_{Move::Combination::kPass};
 
+  template <typename Out> void collect_legal_moves(Out &legal_moves) const;
+  template <typename Out>
+  void collect_possible_moves(Out &possible_moves) const;
+
   friend std::ostream &operator<<(std::ostream &, const PartialGame &);
 };
 
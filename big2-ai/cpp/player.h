@@ -31,6 +31,12 @@ public:
    * @return The move chosen by this player.
    */
   virtual Move select_move() = 0;
+
+  /**
+   * @brief Number of legal moves the last select_move() chose from, as the
+   * player generated them; 0 if the player does not count them.
+   */
+  virtual int last_num_legal_moves() const { return 0; }
 };
 
 #endif // PLAYER_H
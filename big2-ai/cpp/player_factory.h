@@ -2,6 +2,7 @@
 #define PLAYER_FACTORY_H
 
 #include <memory>
+#include <string>
 
 #include "player.h"
 
@@ -19,6 +20,11 @@ public:
    * @return A unique_ptr to the newly constructed Player.
    */
   virtual std::unique_ptr<Player> create_player() = 0;
+
+  /**
+   * @brief Short name of the agent, used in reports.
+   */
+  virtual std::string name() const { return "agent"; }
 };
 
 #endif // PLAYER_FACTORY_H
@@ -47,6 +47,7 @@ public:
     std::vector<int> legal = game_.get_legal_moves();
     if (legal.empty())
       throw std::runtime_error("No legal moves available.");
+    num_legal_ = static_cast<int>(legal.size());
     std::uniform_int_distribution<size_t> dist(0, legal.size() - 1);
     size_t idx = dist(rng_);
     int move_id = legal[idx];
@@ -55,9 +56,12 @@ public:
     return m;
   }
 
+  int last_num_legal_moves() const override { return num_legal_; }
+
 private:
   std::mt19937 rng_;
   PartialGame game_;
+  int num_legal_ = 0;
 };
 
 #endif // RANDOM_PLAYER_H
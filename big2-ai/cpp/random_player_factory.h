@@ -33,6 +33,8 @@ public:
     return player;
   }
 
+  std::string name() const override { return "random"; }
+
 private:
   unsigned int next_seed_;
 };
@@ -0,0 +1,100 @@
+// agent_latency.cpp
+#include "agent_latency.h"
+
+#include <iomanip>
+
+#include "tsc_clock.h"
+
+std::string AgentLatency::legal_class_name(int legal_class) {
+  if (legal_class == 0) {
+    return "1";
+  }
+  const int low = (1 << (legal_class - 1)) + 1;
+  if (legal_class == kNumLegalClasses - 1) {
+    return std::to_string(low) + "+";
+  }
+  const int high = 1 << legal_class;
+  return low == high ? std::to_string(low)
+                     : std::to_string(low) + "-" + std::to_string(high);
+}
+
+AgentLatency::AgentLatency(std::array<std::string, 2> names) {
+  for (int seat = 0; seat < 2; ++seat) {
+    _agents[seat].name = std::move(names[seat]);
+  }
+}
+
+void AgentLatency::merge(const AgentLatency &other) {
+  for (int seat = 0; seat < 2; ++seat) {
+    _agents[seat].total.merge(other._agents[seat].total);
+    for (int c = 0; c < kNumLegalClasses; ++c) {
+      _agents[seat].by_legal[c].merge(other._agents[seat].by_legal[c]);
+    }
+  }
+}
+
+static double micros(double ticks) {
+  return ticks * TscClock::ns_per_tick() / 1e3;
+}
+
+static double share(uint64_t part, uint64_t whole) {
+  return whole ? static_cast<double>(part) / whole : 0.0;
+}
+
+void AgentLatency::print(std::ostream &os) const {
+  const uint64_t all = _agents[0].total.sum() + _agents[1].total.sum();
+  for (int seat = 0; seat < 2; ++seat) {
+    const Agent &agent = _agents[seat];
+    os << "[Latency] seat " << seat << " (" << agent.name
+       << "): " << agent.total.count() << " decisions, "
+       << micros(agent.total.sum()) / 1e6 << " s ("
+       << 100.0 * share(agent.total.sum(), all) << "% of decision time), p50 "
+       << micros(agent.total.quantile(0.5)) << " us, p99 "
+       << micros(agent.total.quantile(0.99)) << " us, max "
+       << micros(agent.total.max()) << " us\n";
+    for (int c = 0; c < kNumLegalClasses; ++c) {
+      const LatencyHistogram &h = agent.by_legal[c];
+      if (h.count() == 0) {
+        continue;
+      }
+      os << "[Latency]   " << legal_class_name(c) << " legal: " << h.count()
+         << " decisions, p50 " << micros(h.quantile(0.5)) << " us, p99 "
+         << micros(h.quantile(0.99)) << " us, max " << micros(h.max())
+         << " us\n";
+    }
+  }
+}
+
+static void write_summary(std::ostream &os, const LatencyHistogram &h) {
+  os << "\"decisions\": " << h.count()
+     << ", \"mean_us\": " << micros(h.mean())
+     << ", \"p50_us\": " << micros(h.quantile(0.5))
+     << ", \"p90_us\": " << micros(h.quantile(0.9))
+     << ", \"p99_us\": " << micros(h.quantile(0.99))
+     << ", \"max_us\": " << micros(h.max());
+}
+
+void AgentLatency::write_json(std::ostream &os) const {
+  const uint64_t all = _agents[0].total.sum() + _agents[1].total.sum();
+  os << std::setprecision(10);
+  os << "{\n";
+  os << "  \"ns_per_tick\": " << TscClock::ns_per_tick() << ",\n";
+  os << "  \"agents\": [\n";
+  for (int seat = 0; seat < 2; ++seat) {
+    const Agent &agent = _agents[seat];
+    os << "    {\"seat\": " << seat << ", \"name\": \"" << agent.name
+       << "\", \"seconds\": " << micros(agent.total.sum()) / 1e6
+       << ", \"share\": " << share(agent.total.sum(), all) << ", ";
+    write_summary(os, agent.total);
+    os << ",\n     \"by_legal_moves\": [";
+    for (int c = 0; c < kNumLegalClasses; ++c) {
+      os << (c ? ",\n       " : "\n       ") << "{\"legal_moves\": \""
+         << legal_class_name(c) << "\", ";
+      write_summary(os, agent.by_legal[c]);
+      os << "}";
+    }
+    os << "]}" << (seat == 0 ? ",\n" : "\n");
+  }
+  os << "  ]\n";
+  os << "}\n";
+}
@@ -0,0 +1,79 @@
+// agent_latency.h
+#ifndef AGENT_LATENCY_H
+#define AGENT_LATENCY_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "latency_histogram.h"
+
+/**
+ * @brief Latency of each agent's move decisions, by number of legal moves.
+ *
+ * GameSimulator times every Player::select_move() in TscClock ticks and adds
+ * it under the seat that moved and the power-of-two class of the legal move
+ * count the player reports (1, 2, 3-4, 5-8, ...). Each simulation thread
+ * owns one instance; merge() combines them. Ticks are converted to time only
+ * when reporting.
+ */
+class AgentLatency {
+public:
+  static constexpr int kNumLegalClasses = 8;
+
+  /**
+   * @brief Class of a legal move count: 0 for 1 move, k for
+   * (2^(k-1), 2^k], the last class open-ended.
+   */
+  static int legal_class(int num_legal) {
+    if (num_legal <= 1) {
+      return 0;
+    }
+    const int bits = 32 - __builtin_clz(static_cast<unsigned>(num_legal - 1));
+    return bits < kNumLegalClasses ? bits : kNumLegalClasses - 1;
+  }
+
+  static std::string legal_class_name(int legal_class);
+
+  /**
+   * @param names Agent name for each seat, used in reports.
+   */
+  explicit AgentLatency(std::array<std::string, 2> names = {"seat0",
+                                                            "seat1"});
+
+  void add(int seat, int num_legal, uint64_t ticks) {
+    _agents[seat].total.add(ticks);
+    _agents[seat].by_legal[legal_class(num_legal)].add(ticks);
+  }
+
+  void merge(const AgentLatency &other);
+
+  const LatencyHistogram &total(int seat) const {
+    return _agents[seat].total;
+  }
+  const LatencyHistogram &by_legal(int seat, int legal_class) const {
+    return _agents[seat].by_legal[legal_class];
+  }
+
+  /**
+   * @brief p50 / p99 / max latency and share of decision time per agent,
+   * then per legal-move class.
+   */
+  void print(std::ostream &os) const;
+
+  /**
+   * @brief The same report, with every class, as JSON (times in us).
+   */
+  void write_json(std::ostream &os) const;
+
+private:
+  struct Agent {
+    std::string name;
+    LatencyHistogram total;
+    std::array<LatencyHistogram, kNumLegalClasses> by_legal;
+  };
+  std::array<Agent, 2> _agents;
+};
+
+#endif // AGENT_LATENCY_H
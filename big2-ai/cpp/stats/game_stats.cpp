@@ -0,0 +1,112 @@
+// game_stats.cpp
+#include "game_stats.h"
+
+#include <iomanip>
+
+using Combination = Move::Combination;
+
+const char *GameStats::family_name(int family) {
+  static const char *const kNames[kNumFamilies] = {
+      "pass", "single",   "double",  "triple",         "full_house",
+      "bomb", "straight", "sisters", "triple_straight"};
+  return family >= 0 && family < kNumFamilies ? kNames[family] : "unknown";
+}
+
+GameStats::Family GameStats::family_of(Combination combination) {
+  if (combination <= Combination::kBomb) {
+    return static_cast<Family>(combination);
+  }
+  if (combination <= Combination::kStraight13) {
+    return kStraight;
+  }
+  if (combination <= Combination::kDoubleStraight8) {
+    return kSisters;
+  }
+  return kTripleStraight;
+}
+
+GameStats::GameStats() = default;
+
+void GameStats::on_deal(const Game &) {
+  _game_start = std::chrono::steady_clock::now();
+}
+
+void GameStats::on_move(int, const Move &move, const Game &) {
+  ++_moves;
+  ++_plays[family_of(move.combination)];
+}
+
+void GameStats::on_game_end(const Game &game, int num_turns) {
+  ++_games;
+  ++_wins[game.get_winner()];
+  _lengths.add(num_turns);
+  _game_micros.add(std::chrono::duration<double, std::micro>(
+                       std::chrono::steady_clock::now() - _game_start)
+                       .count());
+}
+
+void GameStats::merge(const GameStats &other) {
+  _games += other._games;
+  _moves += other._moves;
+  for (int seat = 0; seat < 2; ++seat) {
+    _wins[seat] += other._wins[seat];
+  }
+  for (int f = 0; f < kNumFamilies; ++f) {
+    _plays[f] += other._plays[f];
+  }
+  _lengths.merge(other._lengths);
+  _game_micros.merge(other._game_micros);
+}
+
+static double ratio(uint64_t part, uint64_t whole) {
+  return whole ? static_cast<double>(part) / whole : 0.0;
+}
+
+void GameStats::print(std::ostream &os) const {
+  os << "[Stats] " << _games << " games, " << _moves << " moves\n";
+  os << "[Stats] win rate: seat 0 " << ratio(_wins[0], _games) << ", seat 1 "
+     << ratio(_wins[1], _games) << "\n";
+  os << "[Stats] game length: mean " << _lengths.mean() << ", p50 "
+     << _lengths.quantile(0.5) << ", p90 " << _lengths.quantile(0.9)
+     << ", p99 " << _lengths.quantile(0.99) << "\n";
+  os << "[Stats] pass rate: " << ratio(_plays[kPass], _moves) << "\n";
+  os << "[Stats] plays:";
+  for (int f = 1; f < kNumFamilies; ++f) {
+    os << ' ' << family_name(f) << ' ' << ratio(_plays[f], _moves);
+  }
+  os << "\n[Stats] time per game: p50 " << _game_micros.quantile(0.5)
+     << " us, p99 " << _game_micros.quantile(0.99) << " us\n";
+}
+
+void GameStats::write_json(std::ostream &os) const {
+  os << std::setprecision(10);
+  os << "{\n";
+  os << "  \"games\": " << _games << ",\n";
+  os << "  \"moves\": " << _moves << ",\n";
+  os << "  \"wins\": [" << _wins[0] << ", " << _wins[1] << "],\n";
+  os << "  \"plays\": {";
+  for (int f = 0; f < kNumFamilies; ++f) {
+    os << (f ? ", " : "") << '"' << family_name(f) << "\": " << _plays[f];
+  }
+  os << "},\n";
+  os << "  \"game_length\": {\"mean\": " << _lengths.mean()
+     << ", \"p50\": " << _lengths.quantile(0.5)
+     << ", \"p90\": " << _lengths.quantile(0.9)
+     << ", \"p99\": " << _lengths.quantile(0.99) << ", \"histogram\": [";
+  // Trailing empty bins are left out
+  const auto &bins = _lengths.bins();
+  size_t used = bins.size();
+  while (used > 0 && bins[used - 1] == 0) {
+    --used;
+  }
+  for (size_t i = 0; i < used; ++i) {
+    os << (i ? ", " : "") << bins[i];
+  }
+  os << "]},\n";
+  os << "  \"game_micros\": {\"mean\": " << _game_micros.mean()
+     << ", \"p50\": " << _game_micros.quantile(0.5)
+     << ", \"p90\": " << _game_micros.quantile(0.9)
+     << ", \"p99\": " << _game_micros.quantile(0.99)
+     << ", \"max\": " << _game_micros.max() << "}\n";
+  os << "}\n";
+}
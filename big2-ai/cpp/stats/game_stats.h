@@ -0,0 +1,78 @@
+// game_stats.h
+#ifndef GAME_STATS_H
+#define GAME_STATS_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "game_observer.h"
+#include "histogram.h"
+#include "quantile_sketch.h"
+
+/**
+ * @brief Aggregate statistics over many games, collected as an observer.
+ *
+ * Tracks win rate by seat, the game-length distribution, the pass rate and
+ * how often each combination type is played, plus the wall time per game.
+ * Each simulation thread owns one instance; merge() combines them. Memory
+ * use does not depend on the number of games.
+ */
+class GameStats : public GameObserver {
+public:
+  // Combination families, as in research/avg_game_length.cpp
+  enum Family {
+    kPass,
+    kSingle,
+    kDouble,
+    kTriple,
+    kFullHouse,
+    kBomb,
+    kStraight,
+    kSisters,
+    kTripleStraight,
+    kNumFamilies
+  };
+
+  static const char *family_name(int family);
+  static Family family_of(Move::Combination combination);
+
+  GameStats();
+
+  void on_deal(const Game &game) override;
+  void on_move(int player, const Move &move, const Game &after) override;
+  void on_game_end(const Game &game, int num_turns) override;
+
+  void merge(const GameStats &other);
+
+  uint64_t games() const { return _games; }
+  uint64_t moves() const { return _moves; }
+  uint64_t wins(int seat) const { return _wins[seat]; }
+  uint64_t plays(Family family) const { return _plays[family]; }
+  const Histogram &game_lengths() const { return _lengths; }
+  const QuantileSketch &game_micros() const { return _game_micros; }
+
+  /**
+   * @brief Human-readable summary.
+   */
+  void print(std::ostream &os) const;
+
+  /**
+   * @brief Full statistics (including the length histogram) as JSON.
+   */
+  void write_json(std::ostream &os) const;
+
+private:
+  uint64_t _games = 0;
+  uint64_t _moves = 0;
+  std::array<uint64_t, 2> _wins{};
+  std::array<uint64_t, kNumFamilies> _plays{};
+  // Turns per game; longer games share the last bin
+  Histogram _lengths{256};
+  QuantileSketch _game_micros{0.01};
+  std::chrono::steady_clock::time_point _game_start;
+};
+
+#endif // GAME_STATS_H
@@ -0,0 +1,34 @@
+// histogram.cpp
+#include "histogram.h"
+
+#include <cmath>
+#include <stdexcept>
+
+Histogram::Histogram(size_t num_bins) : _bins(num_bins < 2 ? 2 : num_bins) {}
+
+void Histogram::merge(const Histogram &other) {
+  if (other._bins.size() != _bins.size()) {
+    throw std::invalid_argument("Histogram: cannot merge different sizes.");
+  }
+  for (size_t i = 0; i < _bins.size(); ++i) {
+    _bins[i] += other._bins[i];
+  }
+  _count += other._count;
+  _sum += other._sum;
+}
+
+int64_t Histogram::quantile(double q) const {
+  if (_count == 0) {
+    return 0;
+  }
+  const uint64_t rank = static_cast<uint64_t>(
+      std::ceil(q * static_cast<double>(_count)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < _bins.size(); ++i) {
+    seen += _bins[i];
+    if (seen >= rank && seen > 0) {
+      return static_cast<int64_t>(i);
+    }
+  }
+  return static_cast<int64_t>(_bins.size() - 1);
+}
@@ -0,0 +1,45 @@
+// histogram.h
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Exact counts of small non-negative integers.
+ *
+ * Values 0 .. num_bins - 2 get their own bin; larger values share the last
+ * (overflow) bin. Histograms of the same size merge by adding bins, so each
+ * thread can keep its own and combine them at the end.
+ */
+class Histogram {
+public:
+  explicit Histogram(size_t num_bins);
+
+  void add(int64_t value, uint64_t count = 1) {
+    size_t bin = value < 0 ? 0 : static_cast<size_t>(value);
+    _bins[bin < _bins.size() ? bin : _bins.size() - 1] += count;
+    _count += count;
+    _sum += value * static_cast<int64_t>(count);
+  }
+
+  void merge(const Histogram &other);
+
+  uint64_t count() const { return _count; }
+  double mean() const { return _count ? double(_sum) / _count : 0.0; }
+  const std::vector<uint64_t> &bins() const { return _bins; }
+
+  /**
+   * @brief Smallest value v with at least a fraction q of the values <= v.
+   * Exact unless it falls in the overflow bin.
+   */
+  int64_t quantile(double q) const;
+
+private:
+  std::vector<uint64_t> _bins;
+  uint64_t _count = 0;
+  int64_t _sum = 0;
+};
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,44 @@
+// latency_histogram.cpp
+#include "latency_histogram.h"
+
+uint64_t LatencyHistogram::bucket_low(size_t index) {
+  if (index < 2 * kSubBuckets) {
+    return index;
+  }
+  const uint64_t shift = index / kSubBuckets - 1;
+  return (index - shift * kSubBuckets) << shift;
+}
+
+uint64_t LatencyHistogram::bucket_width(size_t index) {
+  if (index < 2 * kSubBuckets) {
+    return 1;
+  }
+  return uint64_t(1) << (index / kSubBuckets - 1);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+  if (other._buckets.size() > _buckets.size()) {
+    _buckets.resize(other._buckets.size(), 0);
+  }
+  for (size_t i = 0; i < other._buckets.size(); ++i) {
+    _buckets[i] += other._buckets[i];
+  }
+  _count += other._count;
+  _sum += other._sum;
+  _max = std::max(_max, other._max);
+}
+
+uint64_t LatencyHistogram::quantile(double q) const {
+  if (_count == 0) {
+    return 0;
+  }
+  const double rank = std::clamp(q, 0.0, 1.0) * (_count - 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < _buckets.size(); ++i) {
+    seen += _buckets[i];
+    if (seen > rank) {
+      return std::min(_max, bucket_low(i) + bucket_width(i) / 2);
+    }
+  }
+  return _max;
+}
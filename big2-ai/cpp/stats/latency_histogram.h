@@ -0,0 +1,68 @@
+// latency_histogram.h
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief HDR-style histogram of non-negative integer durations (e.g. clock
+ * ticks).
+ *
+ * Values below 2 * kSubBuckets are exact; above that each power of two is
+ * split into kSubBuckets linear buckets, so any reported value is within
+ * 1 / kSubBuckets (about 3%) of the true one. The bucket of a value is found
+ * with one bit scan and a shift, so add() costs a few instructions. Buckets
+ * are allocated up to the largest value seen and histograms merge exactly.
+ */
+class LatencyHistogram {
+public:
+  static constexpr int kSubBucketBits = 5;
+  static constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBucketBits;
+
+  void add(uint64_t value) {
+    const size_t index = bucket_index(value);
+    if (index >= _buckets.size()) {
+      _buckets.resize(index + 1, 0);
+    }
+    ++_buckets[index];
+    ++_count;
+    _sum += value;
+    _max = std::max(_max, value);
+  }
+
+  void merge(const LatencyHistogram &other);
+
+  uint64_t count() const { return _count; }
+  uint64_t sum() const { return _sum; }
+  uint64_t max() const { return _max; }
+  double mean() const { return _count ? double(_sum) / _count : 0.0; }
+
+  /**
+   * @brief Value at quantile q: the middle of the bucket holding it, capped
+   * at the maximum.
+   */
+  uint64_t quantile(double q) const;
+
+private:
+  std::vector<uint64_t> _buckets;
+  uint64_t _count = 0;
+  uint64_t _sum = 0;
+  uint64_t _max = 0;
+
+  static size_t bucket_index(uint64_t value) {
+    if (value < 2 * kSubBuckets) {
+      return static_cast<size_t>(value);
+    }
+    // value = mantissa << shift with mantissa in [kSubBuckets, 2 kSubBuckets)
+    const int shift = 63 - __builtin_clzll(value) - kSubBucketBits;
+    const uint64_t mantissa = value >> shift;
+    return static_cast<size_t>(shift * kSubBuckets + mantissa);
+  }
+
+  static uint64_t bucket_low(size_t index);
+  static uint64_t bucket_width(size_t index);
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,375 @@
+// perf_profiler.cpp
+#include "perf_profiler.h"
+#include "thread_name.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <mutex>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+std::atomic<PerfProfiler *> PerfProfiler::_active{nullptr};
+
+struct PerfProfiler::Shared {
+  std::mutex mutex;
+  bool closed = false;
+  std::vector<ThreadCounters *> running;
+  std::map<std::string, ThreadTotals> exited;
+};
+
+// The calling thread's counters and the profiler state they report to.
+// Destroyed when the thread exits, which closes the counters.
+struct PerfThreadSlot {
+  std::shared_ptr<PerfProfiler::Shared> shared;
+  std::unique_ptr<PerfProfiler::ThreadCounters> counters;
+
+  ~PerfThreadSlot() { release(); }
+
+  // Fold the counters into their name's totals (unless close() already did)
+  // and close them
+  void release() {
+    if (!counters) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(shared->mutex);
+      if (!shared->closed) {
+        counters->fold_into(shared->exited[counters->name()]);
+        auto &running = shared->running;
+        running.erase(std::find(running.begin(), running.end(),
+                                counters.get()));
+      }
+    }
+    counters.reset();
+    shared.reset();
+  }
+};
+static thread_local PerfThreadSlot tls_slot;
+
+const char *PerfProfiler::region_name(int region) {
+  static const char *const kNames[kNumRegions] = {
+      "game",           "select_move", "game_legal_moves", "legal_moves",
+      "possible_moves", "add_move",    "extract"};
+  return region >= 0 && region < kNumRegions ? kNames[region] : "unknown";
+}
+
+const char *PerfProfiler::event_name(int event) {
+  static const char *const kNames[kNumEvents] = {
+      "cycles", "instructions", "cache_misses", "branch_misses",
+      "task_clock_ns"};
+  return event >= 0 && event < kNumEvents ? kNames[event] : "unknown";
+}
+
+void PerfProfiler::Counts::merge(const Counts &other) {
+  calls += other.calls;
+  for (int e = 0; e < kNumEvents; ++e) {
+    events[e] += other.events[e];
+  }
+}
+
+static int open_event(uint32_t type, uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  // This thread only, on any CPU
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+PerfProfiler::ThreadCounters::ThreadCounters(std::string name)
+    : _name(std::move(name)) {
+  static const std::array<std::pair<uint32_t, uint64_t>, kNumEvents> kEvents =
+      {{{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK}}};
+  _fds.fill(-1);
+  _slots.fill(-1);
+  // The first event that opens leads the group; the rest join it, so one
+  // read() returns them all, counted over the same intervals
+  for (int e = 0; e < kNumEvents; ++e) {
+    const int fd = open_event(kEvents[e].first, kEvents[e].second, _leader);
+    if (fd < 0) {
+      continue;
+    }
+    if (_leader < 0) {
+      _leader = fd;
+    }
+    _fds[e] = fd;
+    _slots[e] = _num_open++;
+  }
+}
+
+PerfProfiler::ThreadCounters::~ThreadCounters() { close(); }
+
+void PerfProfiler::ThreadCounters::close() {
+  for (int &fd : _fds) {
+    if (fd >= 0) {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+  _leader = -1;
+}
+
+void PerfProfiler::ThreadCounters::read(Values &values) const {
+  values.fill(0);
+  if (_leader < 0) {
+    return;
+  }
+  // PERF_FORMAT_GROUP: the number of events, then one value per event
+  uint64_t buffer[1 + kNumEvents];
+  const ssize_t wanted = static_cast<ssize_t>(sizeof(uint64_t)) *
+                         (1 + _num_open);
+  if (::read(_leader, buffer, sizeof(buffer)) < wanted) {
+    return;
+  }
+  for (int e = 0; e < kNumEvents; ++e) {
+    if (_slots[e] >= 0) {
+      values[e] = buffer[1 + _slots[e]];
+    }
+  }
+}
+
+void PerfProfiler::ThreadCounters::fold_into(ThreadTotals &totals) const {
+  for (int r = 0; r < kNumRegions; ++r) {
+    totals.regions[r].merge(_regions[r]);
+  }
+  for (int e = 0; e < kNumEvents; ++e) {
+    totals.available[e] = totals.available[e] || _slots[e] >= 0;
+  }
+}
+
+void PerfProfiler::ThreadCounters::add(Region region, const Values &begin,
+                                       const Values &end) {
+  Counts &counts = _regions[region];
+  ++counts.calls;
+  for (int e = 0; e < kNumEvents; ++e) {
+    counts.events[e] += end[e] - begin[e];
+  }
+}
+
+PerfProfiler::PerfProfiler() : _shared(std::make_shared<Shared>()) {}
+
+PerfProfiler::~PerfProfiler() {
+  PerfProfiler *self = this;
+  _active.compare_exchange_strong(self, nullptr);
+}
+
+void PerfProfiler::activate() {
+  _active.store(this, std::memory_order_release);
+}
+
+void PerfProfiler::close() {
+  PerfProfiler *self = this;
+  _active.compare_exchange_strong(self, nullptr);
+  // Threads still running (e.g. the coordinator, pooled extract threads)
+  // are folded now; they release their slots when they exit
+  std::lock_guard<std::mutex> lock(_shared->mutex);
+  for (ThreadCounters *counters : _shared->running) {
+    counters->close();
+    counters->fold_into(_shared->exited[counters->name()]);
+  }
+  _shared->running.clear();
+  _shared->closed = true;
+}
+
+PerfProfiler::ThreadCounters &PerfProfiler::thread_counters() {
+  if (tls_slot.shared != _shared) {
+    // Counters of an earlier profiler, if any, go back to it first
+    tls_slot.release();
+    tls_slot.counters = std::make_unique<ThreadCounters>(ThreadName::get());
+    tls_slot.shared = _shared;
+    std::lock_guard<std::mutex> lock(_shared->mutex);
+    _shared->running.push_back(tls_slot.counters.get());
+  }
+  return *tls_slot.counters;
+}
+
+std::map<std::string, PerfProfiler::ThreadTotals>
+PerfProfiler::threads() const {
+  std::lock_guard<std::mutex> lock(_shared->mutex);
+  auto totals = _shared->exited;
+  for (const ThreadCounters *counters : _shared->running) {
+    counters->fold_into(totals[counters->name()]);
+  }
+  return totals;
+}
+
+// Whether any thread in `threads` could open `event`
+static bool
+any_available(const std::map<std::string, PerfProfiler::ThreadTotals> &threads,
+              int event) {
+  for (const auto &[name, totals] : threads) {
+    if (totals.available[event]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static PerfProfiler::Counts
+sum_region(const std::map<std::string, PerfProfiler::ThreadTotals> &threads,
+           int region) {
+  PerfProfiler::Counts sum;
+  for (const auto &[name, totals] : threads) {
+    sum.merge(totals.regions[region]);
+  }
+  return sum;
+}
+
+bool PerfProfiler::available(Event event) const {
+  return any_available(threads(), event);
+}
+
+PerfProfiler::Counts PerfProfiler::total(Region region) const {
+  return sum_region(threads(), region);
+}
+
+static double ratio(double part, double whole) {
+  return whole > 0 ? part / whole : 0.0;
+}
+
+void PerfProfiler::print(std::ostream &os) const {
+  const auto threads = this->threads();
+  std::array<bool, kNumEvents> available;
+  for (int e = 0; e < kNumEvents; ++e) {
+    available[e] = any_available(threads, e);
+  }
+  const uint64_t games = sum_region(threads, kGame).calls;
+  const uint64_t turns = sum_region(threads, kSelectMove).calls;
+  os << "[Perf] " << games << " games, " << turns << " turns; events:";
+  for (int e = 0; e < kNumEvents; ++e) {
+    os << ' ' << event_name(e) << (available[e] ? "" : " (n/a)");
+  }
+  os << "\n";
+  for (int r = 0; r < kNumRegions; ++r) {
+    const Counts counts = sum_region(threads, r);
+    if (counts.calls == 0) {
+      continue;
+    }
+    os << "[Perf] " << region_name(r) << ": " << counts.calls << " calls";
+    for (int e = 0; e < kNumEvents; ++e) {
+      if (available[e]) {
+        os << ", " << event_name(e) << ' ' << ratio(counts.events[e], games)
+           << "/game " << ratio(counts.events[e], turns) << "/turn";
+      }
+    }
+    if (available[kCycles] && available[kInstructions]) {
+      const double instructions = counts.events[kInstructions];
+      os << ", IPC " << ratio(instructions, counts.events[kCycles]);
+      if (available[kCacheMisses])
+        os << ", cache misses/kinstr "
+           << 1e3 * ratio(counts.events[kCacheMisses], instructions);
+      if (available[kBranchMisses])
+        os << ", branch misses/kinstr "
+           << 1e3 * ratio(counts.events[kBranchMisses], instructions);
+    }
+    os << "\n";
+  }
+  for (const auto &[name, totals] : threads) {
+    const Counts &game = totals.regions[kGame];
+    const Counts &extract = totals.regions[kExtract];
+    if (game.calls == 0 && extract.calls == 0) {
+      continue;
+    }
+    // Simulation threads are summarized over their games, the others over
+    // their extraction chunks
+    const bool simulates = game.calls > 0;
+    const Counts &counts = simulates ? game : extract;
+    os << "[Perf] thread " << (name.empty() ? "?" : name) << ": "
+       << counts.calls << (simulates ? " games" : " extract chunks");
+    if (available[kCycles] && available[kInstructions]) {
+      os << ", IPC "
+         << ratio(counts.events[kInstructions], counts.events[kCycles]);
+    }
+    if (available[kTaskClock]) {
+      os << ", " << counts.events[kTaskClock] / 1e9 << " s";
+    }
+    os << "\n";
+  }
+}
+
+static void write_counts(std::ostream &os, const PerfProfiler::Counts &counts,
+                         const std::array<bool, PerfProfiler::kNumEvents>
+                             &available) {
+  os << "{\"calls\": " << counts.calls;
+  for (int e = 0; e < PerfProfiler::kNumEvents; ++e) {
+    os << ", \"" << PerfProfiler::event_name(e) << "\": ";
+    if (available[e]) {
+      os << counts.events[e];
+    } else {
+      os << "null";
+    }
+  }
+  os << "}";
+}
+
+void PerfProfiler::write_json(std::ostream &os) const {
+  const auto threads = this->threads();
+  std::array<bool, kNumEvents> available;
+  for (int e = 0; e < kNumEvents; ++e) {
+    available[e] = any_available(threads, e);
+  }
+  const uint64_t games = sum_region(threads, kGame).calls;
+  const uint64_t turns = sum_region(threads, kSelectMove).calls;
+  os << std::setprecision(10);
+  os << "{\n";
+  os << "  \"games\": " << games << ",\n";
+  os << "  \"turns\": " << turns << ",\n";
+  os << "  \"total\": {";
+  for (int r = 0; r < kNumRegions; ++r) {
+    os << (r ? ",\n    " : "\n    ") << '"' << region_name(r) << "\": ";
+    write_counts(os, sum_region(threads, r), available);
+  }
+  os << "},\n";
+  // Every available event per game and per turn, plus derived rates
+  const std::pair<const char *, double> units[] = {{"per_game", games},
+                                                   {"per_turn", turns}};
+  for (const auto &[unit, divisor] : units) {
+    os << "  \"" << unit << "\": {";
+    for (int r = 0; r < kNumRegions; ++r) {
+      const Counts counts = sum_region(threads, r);
+      os << (r ? ",\n    " : "\n    ") << '"' << region_name(r) << "\": {";
+      bool first = true;
+      for (int e = 0; e < kNumEvents; ++e) {
+        if (available[e]) {
+          os << (first ? "" : ", ") << '"' << event_name(e)
+             << "\": " << ratio(counts.events[e], divisor);
+          first = false;
+        }
+      }
+      if (available[kCycles] && available[kInstructions]) {
+        os << ", \"ipc\": "
+           << ratio(counts.events[kInstructions], counts.events[kCycles]);
+      }
+      os << "}";
+    }
+    os << "},\n";
+  }
+  // One entry per ThreadName, however many threads carried it
+  os << "  \"threads\": [";
+  bool first_thread = true;
+  for (const auto &[name, totals] : threads) {
+    os << (first_thread ? "\n    " : ",\n    ") << "{\"name\": \"" << name
+       << "\", \"regions\": {";
+    for (int r = 0; r < kNumRegions; ++r) {
+      os << (r ? ", " : "") << '"' << region_name(r) << "\": ";
+      write_counts(os, totals.regions[r], available);
+    }
+    os << "}}";
+    first_thread = false;
+  }
+  os << "]\n";
+  os << "}\n";
+}
@@ -0,0 +1,223 @@
+// perf_profiler.h
+#ifndef PERF_PROFILER_H
+#define PERF_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Hardware performance counters around the engine's hot functions.
+ *
+ * While a profiler is active, each thread that enters a PerfRegion opens
+ * one perf_event_open group for itself (cycles, instructions, cache misses,
+ * branch misses and task clock, user space only) and adds the counter
+ * deltas of every region to its own totals: one read() per region boundary
+ * and no shared state. When the thread exits, its group is closed and its
+ * totals are folded into those of its ThreadName, so short-lived threads
+ * (the workers of each batch) hold no descriptors past their lifetime and
+ * are reported once per name. Counts are inclusive of nested regions.
+ * Events the machine does not offer (e.g. no PMU in a VM) are reported as
+ * missing.
+ *
+ * The regions in the engine compile to nothing unless the build defines
+ * BIG2_PERF_COUNTERS (make PERF_COUNTERS=1).
+ */
+class PerfProfiler {
+public:
+  enum Region {
+    kGame,
+    kSelectMove,
+    kGameLegalMoves,
+    kLegalMoves,
+    kPossibleMoves,
+    kAddMove,
+    kExtract,
+    kNumRegions
+  };
+
+  enum Event {
+    kCycles,
+    kInstructions,
+    kCacheMisses,
+    kBranchMisses,
+    kTaskClock,
+    kNumEvents
+  };
+
+  using Values = std::array<uint64_t, kNumEvents>;
+
+  static const char *region_name(int region);
+  static const char *event_name(int event);
+
+  /**
+   * @brief Calls of one region and the counter totals over them.
+   */
+  struct Counts {
+    uint64_t calls = 0;
+    Values events{};
+
+    void merge(const Counts &other);
+  };
+
+  /**
+   * @brief Region totals of all threads with one name, and the events any
+   * of them could open.
+   */
+  struct ThreadTotals {
+    std::array<Counts, kNumRegions> regions;
+    std::array<bool, kNumEvents> available{};
+  };
+
+  /**
+   * @brief One thread's counter group and region totals.
+   */
+  class ThreadCounters {
+  public:
+    explicit ThreadCounters(std::string name);
+    ~ThreadCounters();
+
+    ThreadCounters(const ThreadCounters &) = delete;
+    ThreadCounters &operator=(const ThreadCounters &) = delete;
+
+    /**
+     * @brief Current value of every open event (0 for the others).
+     */
+    void read(Values &values) const;
+
+    void add(Region region, const Values &begin, const Values &end);
+
+    const std::string &name() const { return _name; }
+    bool available(Event event) const { return _slots[event] >= 0; }
+    const Counts &counts(Region region) const { return _regions[region]; }
+
+    /**
+     * @brief Add this thread's region counts and events to `totals`.
+     */
+    void fold_into(ThreadTotals &totals) const;
+
+    /**
+     * @brief Stop counting and release the file descriptors.
+     */
+    void close();
+
+  private:
+    std::string _name;
+    int _leader = -1;
+    std::array<int, kNumEvents> _fds;
+    // Position of each event in the group's read buffer, or -1
+    std::array<int, kNumEvents> _slots;
+    int _num_open = 0;
+    std::array<Counts, kNumRegions> _regions;
+  };
+
+  PerfProfiler();
+  ~PerfProfiler();
+
+  PerfProfiler(const PerfProfiler &) = delete;
+  PerfProfiler &operator=(const PerfProfiler &) = delete;
+
+  /**
+   * @brief Route regions from every thread to this profiler.
+   */
+  void activate();
+
+  /**
+   * @brief Stop profiling and close the counters of threads still running.
+   * Threads must have left their regions.
+   */
+  void close();
+
+  /**
+   * @brief The profiler receiving regions, or nullptr.
+   */
+  static PerfProfiler *active() {
+    return _active.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Counters of the calling thread, opened on first use.
+   */
+  ThreadCounters &thread_counters();
+
+  /**
+   * @brief Totals per ThreadName, over exited and running threads.
+   */
+  std::map<std::string, ThreadTotals> threads() const;
+
+  /**
+   * @brief Whether any thread could open `event`.
+   */
+  bool available(Event event) const;
+
+  /**
+   * @brief Sum over all threads.
+   */
+  Counts total(Region region) const;
+
+  /**
+   * @brief Per-region totals normalized per game and per turn, with IPC and
+   * misses per thousand instructions, then IPC per thread.
+   */
+  void print(std::ostream &os) const;
+
+  /**
+   * @brief Per-thread-name and total counts, normalized as in print(), as
+   * JSON.
+   */
+  void write_json(std::ostream &os) const;
+
+private:
+  struct Shared;
+  friend struct PerfThreadSlot;
+
+  static std::atomic<PerfProfiler *> _active;
+
+  // Running threads and the totals of exited ones; threads keep it alive
+  // until they exit, which may be after the profiler is gone
+  std::shared_ptr<Shared> _shared;
+};
+
+/**
+ * @brief Counts the enclosing scope as one call of `region` on the active
+ * profiler.
+ */
+class PerfRegion {
+public:
+  explicit PerfRegion(PerfProfiler::Region region)
+      : _region(region), _counters(nullptr) {
+    if (PerfProfiler *profiler = PerfProfiler::active()) {
+      _counters = &profiler->thread_counters();
+      _counters->read(_begin);
+    }
+  }
+  ~PerfRegion() {
+    if (_counters) {
+      PerfProfiler::Values end;
+      _counters->read(end);
+      _counters->add(_region, _begin, end);
+    }
+  }
+  PerfRegion(const PerfRegion &) = delete;
+  PerfRegion &operator=(const PerfRegion &) = delete;
+
+private:
+  PerfProfiler::Region _region;
+  PerfProfiler::ThreadCounters *_counters;
+  PerfProfiler::Values _begin;
+};
+
+#ifdef BIG2_PERF_COUNTERS
+#define BIG2_PERF_REGION(region)                                               \
+  PerfRegion perf_region_(PerfProfiler::region)
+#else
+#define BIG2_PERF_REGION(region)                                               \
+  do {                                                                         \
+  } while (0)
+#endif
+
+#endif // PERF_PROFILER_H
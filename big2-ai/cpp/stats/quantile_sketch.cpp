@@ -0,0 +1,83 @@
+// quantile_sketch.cpp
+#include "quantile_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+QuantileSketch::QuantileSketch(double relative_accuracy)
+    : _accuracy(relative_accuracy) {
+  if (!(relative_accuracy > 0.0 && relative_accuracy < 1.0)) {
+    throw std::invalid_argument("QuantileSketch: accuracy must be in (0, 1).");
+  }
+  _gamma = (1.0 + relative_accuracy) / (1.0 - relative_accuracy);
+  _log_gamma = std::log(_gamma);
+}
+
+int QuantileSketch::bucket_index(double value) const {
+  return static_cast<int>(std::ceil(std::log(value) / _log_gamma));
+}
+
+void QuantileSketch::add_to_bucket(int index, uint64_t count) {
+  if (_buckets.empty()) {
+    _first_index = index;
+    _buckets.push_back(0);
+  } else if (index < _first_index) {
+    _buckets.insert(_buckets.begin(), _first_index - index, 0);
+    _first_index = index;
+  } else if (index >= _first_index + static_cast<int>(_buckets.size())) {
+    _buckets.resize(index - _first_index + 1, 0);
+  }
+  _buckets[index - _first_index] += count;
+}
+
+void QuantileSketch::add(double value) {
+  ++_count;
+  _sum += value;
+  _min = std::min(_min, value);
+  _max = std::max(_max, value);
+  if (value <= 0.0) {
+    ++_zero_count;
+    return;
+  }
+  add_to_bucket(bucket_index(value), 1);
+}
+
+void QuantileSketch::merge(const QuantileSketch &other) {
+  if (other._accuracy != _accuracy) {
+    throw std::invalid_argument(
+        "QuantileSketch: cannot merge sketches of different accuracy.");
+  }
+  for (size_t i = 0; i < other._buckets.size(); ++i) {
+    if (other._buckets[i] != 0) {
+      add_to_bucket(other._first_index + static_cast<int>(i),
+                    other._buckets[i]);
+    }
+  }
+  _zero_count += other._zero_count;
+  _count += other._count;
+  _sum += other._sum;
+  _min = std::min(_min, other._min);
+  _max = std::max(_max, other._max);
+}
+
+double QuantileSketch::quantile(double q) const {
+  if (_count == 0) {
+    return 0.0;
+  }
+  const double rank = std::clamp(q, 0.0, 1.0) * (_count - 1);
+  if (rank < _zero_count) {
+    return 0.0;
+  }
+  uint64_t seen = _zero_count;
+  for (size_t i = 0; i < _buckets.size(); ++i) {
+    seen += _buckets[i];
+    if (seen > rank) {
+      // Midpoint of the bucket (gamma^(k-1), gamma^k] in relative terms
+      const int index = _first_index + static_cast<int>(i);
+      const double value = 2.0 * std::pow(_gamma, index) / (_gamma + 1.0);
+      return std::clamp(value, _min, _max);
+    }
+  }
+  return _max;
+}
@@ -0,0 +1,53 @@
+// quantile_sketch.h
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Mergeable quantile sketch for positive real values.
+ *
+ * Values are counted in logarithmic buckets of width (1 + a) / (1 - a), so
+ * every reported quantile is within relative error `a` of a true sample
+ * (the DDSketch construction). Memory grows with the log of the value range,
+ * not with the number of values, and sketches with the same accuracy merge
+ * exactly by adding buckets.
+ */
+class QuantileSketch {
+public:
+  explicit QuantileSketch(double relative_accuracy = 0.01);
+
+  /**
+   * @brief Count one value; values <= 0 are counted as zero.
+   */
+  void add(double value);
+
+  void merge(const QuantileSketch &other);
+
+  uint64_t count() const { return _count; }
+  double min() const { return _count ? _min : 0.0; }
+  double max() const { return _count ? _max : 0.0; }
+  double mean() const { return _count ? _sum / _count : 0.0; }
+
+  double quantile(double q) const;
+
+private:
+  double _accuracy;
+  double _gamma;
+  double _log_gamma;
+  // _buckets[i] counts values with bucket index _first_index + i
+  std::vector<uint64_t> _buckets;
+  int _first_index = 0;
+  uint64_t _zero_count = 0;
+  uint64_t _count = 0;
+  double _sum = 0.0;
+  double _min = std::numeric_limits<double>::infinity();
+  double _max = -std::numeric_limits<double>::infinity();
+
+  int bucket_index(double value) const;
+  void add_to_bucket(int index, uint64_t count);
+};
+
+#endif // QUANTILE_SKETCH_H
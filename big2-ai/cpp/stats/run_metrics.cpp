@@ -0,0 +1,182 @@
+// run_metrics.cpp
+#include "run_metrics.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sys/resource.h>
+#include <unistd.h>
+
+const char *RunMetrics::phase_name(int phase) {
+  static const char *const kNames[kNumPhases] = {
+      "select_move", "apply_move", "record", "extract", "build_table", "write"};
+  return phase >= 0 && phase < kNumPhases ? kNames[phase] : "unknown";
+}
+
+RunMetrics::RunMetrics(int num_threads, double report_interval)
+    : _coordinator(std::make_unique<Counters>()),
+      _report_interval(report_interval) {
+  for (int t = 0; t < num_threads; ++t) {
+    _threads.push_back(std::make_unique<Counters>());
+  }
+}
+
+RunMetrics::~RunMetrics() { stop(); }
+
+void RunMetrics::add_gauge(const std::string &name,
+                           std::function<double()> read) {
+  _gauges.push_back({name, std::move(read)});
+}
+
+void RunMetrics::start() {
+  _start_ns = now_ns();
+  _stop_ns = 0;
+  if (_report_interval > 0.0) {
+    _reporter = std::thread(&RunMetrics::report_loop, this);
+  }
+}
+
+void RunMetrics::stop() {
+  if (_reporter.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stopping = true;
+    }
+    _wake.notify_all();
+    _reporter.join();
+  }
+  if (_start_ns != 0 && _stop_ns == 0) {
+    _stop_ns = now_ns();
+    sample();
+  }
+}
+
+void RunMetrics::report_loop() {
+  const auto interval = std::chrono::duration<double>(_report_interval);
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (!_wake.wait_for(lock, interval, [&] { return _stopping; })) {
+    sample();
+    print(std::cout);
+  }
+}
+
+uint64_t RunMetrics::rss_bytes() {
+  std::ifstream statm("/proc/self/statm");
+  uint64_t pages = 0;
+  uint64_t resident = 0;
+  if (!(statm >> pages >> resident)) {
+    return 0;
+  }
+  return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+void RunMetrics::sample() {
+  _peak_rss = std::max(_peak_rss, rss_bytes());
+  for (auto &gauge : _gauges) {
+    gauge.last = gauge.read();
+    gauge.peak = std::max(gauge.peak, gauge.last);
+  }
+}
+
+uint64_t RunMetrics::total_games() const {
+  uint64_t total = 0;
+  for (const auto &counters : _threads) {
+    total += counters->games.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+uint64_t RunMetrics::total_turns() const {
+  uint64_t total = 0;
+  for (const auto &counters : _threads) {
+    total += counters->turns.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+uint64_t RunMetrics::phase_nanos(int phase) const {
+  uint64_t total = _coordinator->nanos[phase].load(std::memory_order_relaxed);
+  for (const auto &counters : _threads) {
+    total += counters->nanos[phase].load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+double RunMetrics::elapsed_seconds() const {
+  const uint64_t end = _stop_ns ? _stop_ns : now_ns();
+  return (end - _start_ns) / 1e9;
+}
+
+uint64_t RunMetrics::peak_rss() const {
+  struct rusage usage;
+  const uint64_t max_rss_kb =
+      getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+  return std::max<uint64_t>(_peak_rss, max_rss_kb * 1024);
+}
+
+RunMetrics::Totals RunMetrics::totals() const {
+  Totals totals;
+  totals.seconds = elapsed_seconds();
+  totals.games = total_games();
+  totals.turns = total_turns();
+  totals.peak_rss_bytes = peak_rss();
+  return totals;
+}
+
+static double per_second(uint64_t count, double seconds) {
+  return seconds > 0.0 ? count / seconds : 0.0;
+}
+
+void RunMetrics::print(std::ostream &os) const {
+  const double seconds = elapsed_seconds();
+  const uint64_t games = total_games();
+  os << "[Metrics] " << std::fixed << std::setprecision(1) << seconds
+     << " s: " << games << " games (" << per_second(games, seconds)
+     << " games/s, " << per_second(total_turns(), seconds)
+     << " turns/s), rss " << rss_bytes() / 1e6 << " MB";
+  for (const auto &gauge : _gauges) {
+    os << ", " << gauge.name << ' ' << gauge.last;
+  }
+  os << std::setprecision(3) << "\n[Metrics] thread seconds:";
+  for (int p = 0; p < kNumPhases; ++p) {
+    os << ' ' << phase_name(p) << ' ' << phase_nanos(p) / 1e9;
+  }
+  os << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+void RunMetrics::write_json(std::ostream &os) const {
+  const double seconds = elapsed_seconds();
+  const uint64_t games = total_games();
+  const uint64_t turns = total_turns();
+  os << std::setprecision(10);
+  os << "{\n";
+  os << "  \"elapsed_seconds\": " << seconds << ",\n";
+  os << "  \"threads\": " << _threads.size() << ",\n";
+  os << "  \"games\": " << games << ",\n";
+  os << "  \"turns\": " << turns << ",\n";
+  os << "  \"games_per_second\": " << per_second(games, seconds) << ",\n";
+  os << "  \"turns_per_second\": " << per_second(turns, seconds) << ",\n";
+  // Summed over threads, so simulation phases can exceed the wall time
+  os << "  \"phase_seconds\": {";
+  for (int p = 0; p < kNumPhases; ++p) {
+    os << (p ? ", " : "") << '"' << phase_name(p)
+       << "\": " << phase_nanos(p) / 1e9;
+  }
+  os << "},\n";
+  os << "  \"per_thread\": [";
+  for (size_t t = 0; t < _threads.size(); ++t) {
+    os << (t ? ", " : "") << "{\"games\": " << _threads[t]->games.load()
+       << ", \"turns\": " << _threads[t]->turns.load() << "}";
+  }
+  os << "],\n";
+  os << "  \"peak_rss_bytes\": " << peak_rss() << ",\n";
+  os << "  \"gauges\": {";
+  for (size_t g = 0; g < _gauges.size(); ++g) {
+    os << (g ? ", " : "") << '"' << _gauges[g].name
+       << "\": {\"last\": " << _gauges[g].last
+       << ", \"peak\": " << _gauges[g].peak << "}";
+  }
+  os << "}\n";
+  os << "}\n";
+}
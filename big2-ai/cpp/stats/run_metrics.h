@@ -0,0 +1,193 @@
+// run_metrics.h
+#ifndef RUN_METRICS_H
+#define RUN_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Throughput counters and phase timers of one run_all().
+ *
+ * Every simulation thread owns one cache-line-aligned Counters slot and is
+ * its only writer, so updating it is a plain load and store with no locked
+ * instruction or shared line. A reporter thread reads all slots every
+ * `report_interval` seconds and prints games/s, turns/s, the time spent in
+ * each phase, RSS and the sampled gauges (e.g. writer queue depths).
+ */
+class RunMetrics {
+public:
+  enum Phase {
+    kSelectMove,
+    kApplyMove,
+    kRecord,
+    kExtract,
+    kBuildTable,
+    kWrite,
+    kNumPhases
+  };
+
+  static const char *phase_name(int phase);
+
+  static uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /**
+   * @brief Counters written by a single thread, read by any.
+   */
+  struct alignas(64) Counters {
+    std::atomic<uint64_t> games{0};
+    std::atomic<uint64_t> turns{0};
+    std::array<std::atomic<uint64_t>, kNumPhases> nanos{};
+
+    void add_game(uint64_t num_turns) {
+      bump(games, 1);
+      bump(turns, num_turns);
+    }
+
+    void add_time(Phase phase, uint64_t ns) { bump(nanos[phase], ns); }
+
+    /**
+     * @brief Charge the time since `since` to `phase`; returns the current
+     * time for the next lap.
+     */
+    uint64_t lap(Phase phase, uint64_t since) {
+      const uint64_t now = now_ns();
+      add_time(phase, now - since);
+      return now;
+    }
+
+  private:
+    static void bump(std::atomic<uint64_t> &value, uint64_t delta) {
+      value.store(value.load(std::memory_order_relaxed) + delta,
+                  std::memory_order_relaxed);
+    }
+  };
+
+  /**
+   * @brief Times a scope into one phase of a Counters slot (if not null).
+   */
+  class ScopedTimer {
+  public:
+    ScopedTimer(Counters *counters, Phase phase)
+        : _counters(counters), _phase(phase),
+          _start(counters ? now_ns() : 0) {}
+    ~ScopedTimer() {
+      if (_counters) {
+        _counters->lap(_phase, _start);
+      }
+    }
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+  private:
+    Counters *_counters;
+    Phase _phase;
+    uint64_t _start;
+  };
+
+  /**
+   * @param num_threads     Number of simulation threads (one slot each).
+   * @param report_interval Seconds between progress lines; 0 disables them.
+   */
+  RunMetrics(int num_threads, double report_interval);
+  ~RunMetrics();
+
+  Counters &thread(int t) { return *_threads.at(t); }
+
+  /**
+   * @brief Slot of the coordinating thread (extraction and writing).
+   */
+  Counters &coordinator() { return *_coordinator; }
+
+  /**
+   * @brief Sample `read` with every report and keep its last and peak
+   * values, e.g. the depth of a writer queue. Add before start().
+   */
+  void add_gauge(const std::string &name, std::function<double()> read);
+
+  /**
+   * @brief Start the clock and the reporter thread.
+   */
+  void start();
+
+  /**
+   * @brief Stop the clock and the reporter; takes a final sample.
+   */
+  void stop();
+
+  /**
+   * @brief Progress so far: throughput, RSS, gauges and phase times.
+   */
+  void print(std::ostream &os) const;
+
+  /**
+   * @brief Final totals, per-thread counts, phase times, peak RSS and
+   * gauges as JSON.
+   */
+  void write_json(std::ostream &os) const;
+
+  /**
+   * @brief Headline numbers of a run.
+   */
+  struct Totals {
+    double seconds = 0.0;
+    uint64_t games = 0;
+    uint64_t turns = 0;
+    uint64_t peak_rss_bytes = 0;
+  };
+
+  /**
+   * @brief Elapsed time, games, turns and peak RSS so far.
+   */
+  Totals totals() const;
+
+  /**
+   * @brief Resident set size of this process in bytes (0 if unknown).
+   */
+  static uint64_t rss_bytes();
+
+private:
+  struct Gauge {
+    std::string name;
+    std::function<double()> read;
+    double last = 0.0;
+    double peak = 0.0;
+  };
+
+  std::vector<std::unique_ptr<Counters>> _threads;
+  std::unique_ptr<Counters> _coordinator;
+  std::vector<Gauge> _gauges;
+  double _report_interval;
+
+  uint64_t _start_ns = 0;
+  uint64_t _stop_ns = 0;
+  uint64_t _peak_rss = 0;
+
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  bool _stopping = false;
+  std::thread _reporter;
+
+  void report_loop();
+  void sample();
+  uint64_t total_games() const;
+  uint64_t total_turns() const;
+  uint64_t phase_nanos(int phase) const;
+  double elapsed_seconds() const;
+  uint64_t peak_rss() const;
+};
+
+#endif // RUN_METRICS_H
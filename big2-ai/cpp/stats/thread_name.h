@@ -0,0 +1,26 @@
+// thread_name.h
+#ifndef THREAD_NAME_H
+#define THREAD_NAME_H
+
+#include <string>
+
+/**
+ * @brief Label of the calling thread in traces and per-thread reports.
+ *
+ * Set it before the thread's first trace span or counter region; threads
+ * with the same name (e.g. the workers of successive batches) are reported
+ * together.
+ */
+class ThreadName {
+public:
+  static void set(const std::string &name) { current() = name; }
+  static const std::string &get() { return current(); }
+
+private:
+  static std::string &current() {
+    static thread_local std::string name;
+    return name;
+  }
+};
+
+#endif // THREAD_NAME_H
@@ -0,0 +1,105 @@
+// trace_recorder.cpp
+#include "trace_recorder.h"
+#include "thread_name.h"
+
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <stdexcept>
+
+std::atomic<TraceRecorder *> TraceRecorder::_active{nullptr};
+std::atomic<uint64_t> TraceRecorder::_next_generation{1};
+
+// The calling thread's buffer in the recorder of `generation`, if any
+struct TraceThreadSlot {
+  uint64_t generation = 0;
+  void *buffer = nullptr;
+};
+static thread_local TraceThreadSlot tls_slot;
+
+TraceRecorder::TraceRecorder(const std::string &path)
+    : _path(path), _generation(_next_generation.fetch_add(1)) {}
+
+TraceRecorder::~TraceRecorder() {
+  TraceRecorder *self = this;
+  _active.compare_exchange_strong(self, nullptr);
+}
+
+void TraceRecorder::activate() {
+  _start = TscClock::now();
+  _active.store(this, std::memory_order_release);
+}
+
+TraceRecorder::ThreadBuffer &TraceRecorder::thread_buffer() {
+  if (tls_slot.generation != _generation) {
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->name = ThreadName::get();
+    buffer->spans.reserve(1024);
+    tls_slot.buffer = buffer.get();
+    tls_slot.generation = _generation;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _buffers.push_back(std::move(buffer));
+  }
+  return *static_cast<ThreadBuffer *>(tls_slot.buffer);
+}
+
+void TraceRecorder::record(const char *name, uint64_t begin, uint64_t end) {
+  thread_buffer().spans.push_back({name, begin, end});
+}
+
+void TraceRecorder::close() {
+  TraceRecorder *self = this;
+  if (!_active.compare_exchange_strong(self, nullptr)) {
+    return;
+  }
+  write_json();
+}
+
+void TraceRecorder::write_json() const {
+  std::ofstream out(_path);
+  if (!out) {
+    throw std::runtime_error("Could not open trace file " + _path);
+  }
+  const double us_per_tick = TscClock::ns_per_tick() / 1e3;
+
+  // Threads with the same name share a tid, so each worker slot is one row
+  std::map<std::string, int> tids;
+  std::vector<int> buffer_tids;
+  for (size_t b = 0; b < _buffers.size(); ++b) {
+    const std::string &name = _buffers[b]->name;
+    if (name.empty()) {
+      buffer_tids.push_back(-static_cast<int>(b) - 1);
+      continue;
+    }
+    const int next = static_cast<int>(tids.size()) + 1;
+    buffer_tids.push_back(tids.emplace(name, next).first->second);
+  }
+
+  out << std::fixed << std::setprecision(3);
+  out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+  bool first = true;
+  for (const auto &[name, tid] : tids) {
+    out << (first ? "" : ",\n")
+        << "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": "
+        << tid << ", \"args\": {\"name\": \"" << name << "\"}}";
+    first = false;
+  }
+  for (size_t b = 0; b < _buffers.size(); ++b) {
+    // Unnamed threads are numbered after the named ones
+    const int tid = buffer_tids[b] > 0
+                        ? buffer_tids[b]
+                        : static_cast<int>(tids.size()) - buffer_tids[b];
+    for (const Span &span : _buffers[b]->spans) {
+      out << (first ? "" : ",\n") << "{\"ph\": \"X\", \"name\": \""
+          << span.name << "\", \"pid\": 1, \"tid\": " << tid
+          << ", \"ts\": "
+          << static_cast<int64_t>(span.begin - _start) * us_per_tick
+          << ", \"dur\": " << (span.end - span.begin) * us_per_tick << "}";
+      first = false;
+    }
+  }
+  out << "\n]}\n";
+  if (!out) {
+    throw std::runtime_error("Could not write trace file " + _path);
+  }
+}
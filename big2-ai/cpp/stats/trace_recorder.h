@@ -0,0 +1,105 @@
+// trace_recorder.h
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "tsc_clock.h"
+
+/**
+ * @brief Timeline of what every thread was doing, as Chrome trace JSON.
+ *
+ * While a recorder is active, each TraceSpan appends one {name, begin, end}
+ * entry to a buffer owned by the calling thread (registered on its first
+ * span), so recording takes no lock and two TscClock reads. close() writes
+ * all buffers as complete ("X") events that chrome://tracing and
+ * ui.perfetto.dev open directly, one row per ThreadName; gaps between spans
+ * are idle time. With no active recorder a span costs one atomic load.
+ */
+class TraceRecorder {
+public:
+  explicit TraceRecorder(const std::string &path);
+  ~TraceRecorder();
+
+  TraceRecorder(const TraceRecorder &) = delete;
+  TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+  /**
+   * @brief Route spans from every thread to this recorder.
+   */
+  void activate();
+
+  /**
+   * @brief Stop recording and write the trace. Threads must have finished
+   * their spans.
+   */
+  void close();
+
+  /**
+   * @brief The recorder receiving spans, or nullptr.
+   */
+  static TraceRecorder *active() {
+    return _active.load(std::memory_order_acquire);
+  }
+
+  void record(const char *name, uint64_t begin, uint64_t end);
+
+private:
+  struct Span {
+    const char *name;
+    uint64_t begin;
+    uint64_t end;
+  };
+  struct ThreadBuffer {
+    std::string name;
+    std::vector<Span> spans;
+  };
+
+  static std::atomic<TraceRecorder *> _active;
+  static std::atomic<uint64_t> _next_generation;
+
+  std::string _path;
+  uint64_t _generation;
+  uint64_t _start = 0;
+  std::mutex _mutex; // guards _buffers (registration only)
+  std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+
+  ThreadBuffer &thread_buffer();
+  void write_json() const;
+};
+
+/**
+ * @brief Records the enclosing scope as one span of the active recorder.
+ * `name` must outlive the recorder (a string literal).
+ */
+class TraceSpan {
+public:
+  explicit TraceSpan(const char *name)
+      : _recorder(TraceRecorder::active()), _name(name),
+        _begin(_recorder ? TscClock::now() : 0) {}
+  ~TraceSpan() { end(); }
+
+  /**
+   * @brief End the span before the scope does.
+   */
+  void end() {
+    if (_recorder) {
+      _recorder->record(_name, _begin, TscClock::now());
+      _recorder = nullptr;
+    }
+  }
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+  TraceRecorder *_recorder;
+  const char *_name;
+  uint64_t _begin;
+};
+
+#endif // TRACE_RECORDER_H
@@ -0,0 +1,20 @@
+// tsc_clock.cpp
+#include "tsc_clock.h"
+
+#include <thread>
+
+static double calibrate() {
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  const uint64_t first = TscClock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const uint64_t last = TscClock::now();
+  const double ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  return last > first ? ns / (last - first) : 1.0;
+}
+
+double TscClock::ns_per_tick() {
+  static const double kNsPerTick = calibrate();
+  return kNsPerTick;
+}
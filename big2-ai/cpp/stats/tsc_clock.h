@@ -0,0 +1,42 @@
+// tsc_clock.h
+#ifndef TSC_CLOCK_H
+#define TSC_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief Cycle-counter clock for timing short calls.
+ *
+ * Reads the time-stamp counter (x86) or the virtual counter (AArch64): a
+ * few nanoseconds and no system call, against ~20 ns for steady_clock.
+ * Assumes an invariant counter, as on every CPU of the last decade. Other
+ * targets fall back to steady_clock in nanoseconds.
+ */
+class TscClock {
+public:
+  static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+  }
+
+  /**
+   * @brief Length of one tick, measured against steady_clock on first use.
+   */
+  static double ns_per_tick();
+};
+
+#endif // TSC_CLOCK_H
@@ -0,0 +1,185 @@
+// game_archive_test.cpp
+#include "game_archive.h"
+#include "game_archive_reader.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "game_simulator.h"
+#include "greedy_player_factory.h"
+#include "move.h"
+#include "random_player_factory.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__,    \
+                   #cond);                                                     \
+      ++failures;                                                              \
+    }                                                                          \
+  } while (0)
+
+template <typename F> static bool throws(F &&f) {
+  try {
+    f();
+  } catch (const std::exception &) {
+    return true;
+  }
+  return false;
+}
+
+static std::vector<uint8_t> encode(const GameRecord &record) {
+  std::vector<uint8_t> bytes(GameArchiveCodec::kMaxFixedBytes +
+                             GameArchiveCodec::kMaxMoveBytes *
+                                 record.turns().size());
+  const uint8_t *end = GameArchiveCodec::encode(record, bytes.data());
+  CHECK(end <= bytes.data() + bytes.size());
+  bytes.resize(static_cast<size_t>(end - bytes.data()));
+  return bytes;
+}
+
+// Deal, players and move ids of the archived game match the record
+static bool same_game(const ArchivedGame &game, const GameRecord &record) {
+  const Game &initial = record.initial_game();
+  if (game.hands[0] != initial.player_hand(0) ||
+      game.hands[1] != initial.player_hand(1) ||
+      game.first_player != initial.current_player() ||
+      game.winner != record.game().get_winner() ||
+      game.moves.size() != record.turns().size()) {
+    return false;
+  }
+  for (size_t t = 0; t < game.moves.size(); ++t) {
+    if (game.moves[t] != encodeMove(record.turns()[t].move)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Greedy and random self-play, so move ids span one- and two-byte varints
+static std::vector<GameRecord> play_games(int count) {
+  GreedyPlayerFactory greedy;
+  RandomPlayerFactory random(7);
+  std::mt19937 rng(11);
+  std::vector<GameRecord> records;
+  for (int g = 0; g < count; ++g) {
+    PlayerFactory &factory =
+        g % 2 == 0 ? static_cast<PlayerFactory &>(greedy) : random;
+    GameSimulator sim(factory.create_player(), factory.create_player(), rng,
+                      nullptr, g);
+    records.push_back(sim.run());
+  }
+  return records;
+}
+
+int main() {
+  const std::vector<GameRecord> records = play_games(200);
+
+  // Codec round trip, and replaying the decoded game reproduces the record
+  bool two_byte_move = false;
+  for (const GameRecord &record : records) {
+    const std::vector<uint8_t> bytes = encode(record);
+    const uint8_t *begin = bytes.data();
+    const uint8_t *end = begin + bytes.size();
+    const ArchivedGame game = GameArchiveCodec::decode(begin, end);
+    CHECK(same_game(game, record));
+    for (int id : game.moves) {
+      two_byte_move = two_byte_move || id >= 128;
+    }
+
+    const GameRecord replayed = game.replay();
+    CHECK(replayed.game().get_winner() == record.game().get_winner());
+    CHECK(replayed.turns().size() == record.turns().size());
+    for (size_t t = 0; t < replayed.turns().size(); ++t) {
+      CHECK(replayed.turns()[t].legal_moves == record.turns()[t].legal_moves);
+    }
+
+    // Every truncation is rejected
+    for (const uint8_t *cut = begin; cut < end; ++cut) {
+      CHECK(throws([&] { GameArchiveCodec::decode(begin, cut); }));
+    }
+  }
+  CHECK(two_byte_move);
+
+  // A move count of 200 takes a two-byte varint
+  {
+    std::vector<uint8_t> bytes(9, 0);
+    bytes.push_back(0xc8);
+    bytes.push_back(0x01);
+    bytes.insert(bytes.end(), 200, 0x05);
+    const ArchivedGame game =
+        GameArchiveCodec::decode(bytes.data(), bytes.data() + bytes.size());
+    CHECK(game.moves.size() == 200 && game.moves.back() == 5);
+  }
+
+  // Malformed records: a varint running past 64 bits, a move id out of range
+  {
+    std::vector<uint8_t> bytes(9, 0);
+    bytes.insert(bytes.end(), 10, 0xff);
+    CHECK(throws([&] {
+      GameArchiveCodec::decode(bytes.data(), bytes.data() + bytes.size());
+    }));
+    bytes.resize(9);
+    const uint8_t bad_move[] = {1, 0xff, 0x7f};
+    bytes.insert(bytes.end(), bad_move, bad_move + 3);
+    CHECK(throws([&] {
+      GameArchiveCodec::decode(bytes.data(), bytes.data() + bytes.size());
+    }));
+  }
+
+  // Writer and reader: two buffers, out-of-order ids and gaps in the index
+  char path_template[] = "/tmp/game_archive_test.XXXXXX";
+  const int fd = mkstemp(path_template);
+  if (fd < 0) {
+    std::perror("mkstemp");
+    return 1;
+  }
+  close(fd);
+  const std::string path = path_template;
+  {
+    GameArchiveWriter writer(path);
+    {
+      GameArchiveWriter::Buffer even(writer, 4096);
+      GameArchiveWriter::Buffer odd(writer, 4096);
+      for (size_t g = records.size(); g-- > 0;) {
+        if (g % 3 == 2) {
+          continue;
+        }
+        (g % 2 == 0 ? even : odd).append(g, records[g]);
+      }
+    }
+    writer.close();
+    CHECK(writer.num_games() == records.size());
+  }
+  {
+    GameArchiveReader reader(path);
+    CHECK(reader.num_games() == records.size());
+    for (size_t g = 0; g < records.size(); ++g) {
+      if (g % 3 == 2) {
+        CHECK(!reader.contains(g));
+        CHECK(throws([&] { reader.game(g); }));
+        continue;
+      }
+      CHECK(reader.contains(g));
+      const ArchivedGame game = reader.game(g);
+      CHECK(game.game_id == g);
+      CHECK(same_game(game, records[g]));
+    }
+  }
+  unlink(path.c_str());
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("game_archive_test: OK\n");
+  return 0;
+}
@@ -0,0 +1,142 @@
+// latency_histogram_test.cpp
+#include "agent_latency.h"
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__,    \
+                   #cond);                                                     \
+      ++failures;                                                              \
+    }                                                                          \
+  } while (0)
+
+static const double kQuantiles[] = {0.0, 0.01, 0.1,  0.25,  0.5,
+                                    0.75, 0.9, 0.99, 0.999, 1.0};
+
+// Reported value vs the sample at rank q * (n - 1): exact below
+// 2 * kSubBuckets, within 1 / kSubBuckets above
+static bool within_bound(uint64_t estimate, uint64_t expected) {
+  if (expected < 2 * LatencyHistogram::kSubBuckets) {
+    return estimate == expected;
+  }
+  const uint64_t error =
+      estimate > expected ? estimate - expected : expected - estimate;
+  return error * LatencyHistogram::kSubBuckets <= expected;
+}
+
+static void check_histogram() {
+  std::mt19937_64 rng(3);
+  // Tick counts from a handful to about 10^9
+  std::lognormal_distribution<double> ticks(8.0, 3.0);
+  std::vector<uint64_t> values;
+  LatencyHistogram whole;
+  std::vector<LatencyHistogram> parts(4);
+  for (int i = 0; i < 50000; ++i) {
+    const uint64_t value =
+        i % 100 == 0 ? static_cast<uint64_t>(i / 100 % 64)
+                     : static_cast<uint64_t>(ticks(rng));
+    values.push_back(value);
+    whole.add(value);
+    parts[i % parts.size()].add(value);
+  }
+  std::sort(values.begin(), values.end());
+  CHECK(whole.max() == values.back());
+
+  for (double q : kQuantiles) {
+    const uint64_t expected =
+        values[static_cast<size_t>(q * (values.size() - 1))];
+    const uint64_t estimate = whole.quantile(q);
+    if (!within_bound(estimate, expected)) {
+      std::fprintf(stderr, "q=%g: %llu vs %llu\n", q,
+                   static_cast<unsigned long long>(estimate),
+                   static_cast<unsigned long long>(expected));
+      ++failures;
+    }
+  }
+
+  // Merged in an order that grows the target's buckets, then compared
+  // with one histogram fed every value
+  LatencyHistogram merged;
+  std::sort(parts.begin(), parts.end(),
+            [](const LatencyHistogram &a, const LatencyHistogram &b) {
+              return a.max() < b.max();
+            });
+  for (const LatencyHistogram &part : parts) {
+    merged.merge(part);
+  }
+  CHECK(merged.count() == whole.count());
+  CHECK(merged.sum() == whole.sum());
+  CHECK(merged.max() == whole.max());
+  for (double q : kQuantiles) {
+    CHECK(merged.quantile(q) == whole.quantile(q));
+  }
+
+  // Every value below 2 * kSubBuckets has its own bucket
+  LatencyHistogram small;
+  for (uint64_t v = 0; v < 2 * LatencyHistogram::kSubBuckets; ++v) {
+    small.add(v);
+  }
+  for (uint64_t v = 0; v < 2 * LatencyHistogram::kSubBuckets; ++v) {
+    // Rank v + 0.5 of the 0 .. 63 values
+    const double q = (v + 0.5) / (small.count() - 1);
+    CHECK(small.quantile(q) == v);
+  }
+  CHECK(LatencyHistogram().quantile(0.5) == 0);
+}
+
+static void check_agent_latency() {
+  AgentLatency whole;
+  AgentLatency parts[2];
+  for (int i = 0; i < 1000; ++i) {
+    const int seat = i % 2;
+    const int num_legal = 1 + i % 300;
+    const uint64_t ticks = 100 + static_cast<uint64_t>(i) * 37;
+    whole.add(seat, num_legal, ticks);
+    parts[i % 3 == 0].add(seat, num_legal, ticks);
+  }
+  AgentLatency merged;
+  merged.merge(parts[0]);
+  merged.merge(parts[1]);
+  for (int seat = 0; seat < 2; ++seat) {
+    CHECK(merged.total(seat).count() == 500);
+    CHECK(merged.total(seat).sum() == whole.total(seat).sum());
+    uint64_t by_class = 0;
+    for (int c = 0; c < AgentLatency::kNumLegalClasses; ++c) {
+      CHECK(merged.by_legal(seat, c).count() ==
+            whole.by_legal(seat, c).count());
+      CHECK(merged.by_legal(seat, c).quantile(0.5) ==
+            whole.by_legal(seat, c).quantile(0.5));
+      by_class += merged.by_legal(seat, c).count();
+    }
+    CHECK(by_class == merged.total(seat).count());
+  }
+
+  // 1, 2, 3-4, 5-8, ...; the last class is open-ended
+  CHECK(AgentLatency::legal_class(1) == 0);
+  CHECK(AgentLatency::legal_class(2) == 1);
+  CHECK(AgentLatency::legal_class(4) == 2);
+  CHECK(AgentLatency::legal_class(5) == 3);
+  CHECK(AgentLatency::legal_class(64) == 6);
+  CHECK(AgentLatency::legal_class(65) == 7);
+  CHECK(AgentLatency::legal_class(1000) == AgentLatency::kNumLegalClasses - 1);
+}
+
+int main() {
+  check_histogram();
+  check_agent_latency();
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("latency_histogram_test: OK\n");
+  return 0;
+}
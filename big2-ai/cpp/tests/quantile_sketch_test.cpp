@@ -0,0 +1,133 @@
+// quantile_sketch_test.cpp
+#include "histogram.h"
+#include "quantile_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__,    \
+                   #cond);                                                     \
+      ++failures;                                                              \
+    }                                                                          \
+  } while (0)
+
+static const double kQuantiles[] = {0.0, 0.01, 0.1,  0.25,  0.5,
+                                    0.75, 0.9, 0.99, 0.999, 1.0};
+
+static void check_histogram() {
+  constexpr size_t kBins = 64;
+  std::mt19937 rng(1);
+  std::geometric_distribution<int> lengths(0.05);
+
+  // Values past the last bin (and negatives) are clamped, as add() does
+  std::vector<int64_t> values;
+  Histogram whole(kBins);
+  std::vector<Histogram> parts(4, Histogram(kBins));
+  for (int i = 0; i < 20000; ++i) {
+    const int64_t value = i % 1000 == 0 ? -3 : lengths(rng);
+    values.push_back(std::clamp<int64_t>(value, 0, kBins - 1));
+    whole.add(value);
+    parts[i % parts.size()].add(value);
+  }
+  std::sort(values.begin(), values.end());
+
+  // Smallest v with at least a fraction q of the values <= v
+  for (double q : kQuantiles) {
+    const size_t rank = static_cast<size_t>(std::ceil(q * values.size()));
+    const int64_t expected = values[rank > 0 ? rank - 1 : 0];
+    if (expected < static_cast<int64_t>(kBins) - 1) {
+      CHECK(whole.quantile(q) == expected);
+    }
+  }
+  CHECK(whole.quantile(1.0) == static_cast<int64_t>(kBins) - 1);
+
+  Histogram merged(kBins);
+  for (const Histogram &part : parts) {
+    merged.merge(part);
+  }
+  CHECK(merged.bins() == whole.bins());
+  CHECK(merged.count() == whole.count());
+  CHECK(merged.mean() == whole.mean());
+
+  bool threw = false;
+  try {
+    merged.merge(Histogram(kBins + 1));
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  CHECK(threw);
+  CHECK(Histogram(kBins).quantile(0.5) == 0);
+}
+
+static void check_sketch(double accuracy) {
+  std::mt19937 rng(2);
+  // About ten decades in random order, so buckets grow at both ends
+  std::lognormal_distribution<double> spread(0.0, 4.0);
+  std::vector<double> values;
+  QuantileSketch whole(accuracy);
+  std::vector<QuantileSketch> parts(4, QuantileSketch(accuracy));
+  for (int i = 0; i < 50000; ++i) {
+    const double value = i % 500 == 0 ? 0.0 : spread(rng);
+    values.push_back(value);
+    whole.add(value);
+    parts[i % parts.size()].add(value);
+  }
+  std::sort(values.begin(), values.end());
+
+  QuantileSketch merged(accuracy);
+  for (const QuantileSketch &part : parts) {
+    merged.merge(part);
+  }
+  CHECK(merged.count() == whole.count());
+  CHECK(merged.min() == values.front() && merged.max() == values.back());
+
+  // Within relative error `accuracy` of the sample at rank q * (n - 1); the
+  // merged sketch holds the same buckets, so it answers identically
+  for (double q : kQuantiles) {
+    const double expected =
+        values[static_cast<size_t>(q * (values.size() - 1))];
+    const double estimate = whole.quantile(q);
+    if (expected == 0.0) {
+      CHECK(estimate == 0.0);
+    } else {
+      const double error = std::abs(estimate - expected) / expected;
+      if (error > accuracy * (1 + 1e-9)) {
+        std::fprintf(stderr, "q=%g: %g vs %g (error %g > %g)\n", q, estimate,
+                     expected, error, accuracy);
+        ++failures;
+      }
+    }
+    CHECK(merged.quantile(q) == estimate);
+  }
+
+  bool threw = false;
+  try {
+    merged.merge(QuantileSketch(accuracy * 2));
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  CHECK(threw);
+}
+
+int main() {
+  check_histogram();
+  check_sketch(0.01);
+  check_sketch(0.05);
+  CHECK(QuantileSketch().quantile(0.5) == 0.0);
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("quantile_sketch_test: OK\n");
+  return 0;
+}
@@ -0,0 +1,190 @@
+// thrift_compact_test.cpp
+#include "tools/thrift_compact.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__,    \
+                   #cond);                                                     \
+      ++failures;                                                              \
+    }                                                                          \
+  } while (0)
+
+static std::string encode(const ThriftValue &value) {
+  ThriftCompactWriter writer;
+  writer.write_struct(value);
+  return writer.buffer();
+}
+
+static ThriftValue decode(const std::string &bytes) {
+  ThriftCompactReader reader(reinterpret_cast<const uint8_t *>(bytes.data()),
+                             bytes.size());
+  ThriftValue value = reader.read_struct();
+  CHECK(reader.position() == bytes.size());
+  return value;
+}
+
+static ThriftValue make_struct() {
+  ThriftValue value;
+  value.type = ThriftType::kStruct;
+  return value;
+}
+
+static ThriftValue make_binary(const std::string &text) {
+  ThriftValue value;
+  value.type = ThriftType::kBinary;
+  value.binary = text;
+  return value;
+}
+
+static ThriftValue make_list(ThriftType element_type) {
+  ThriftValue value;
+  value.type = ThriftType::kList;
+  value.element_type = element_type;
+  return value;
+}
+
+// Every wire type, both field-header forms and both list-header forms
+static ThriftValue sample_struct() {
+  ThriftValue inner = make_struct();
+  inner.set_field(1,
+                  ThriftValue::Integer(ThriftType::kI64, -(int64_t{1} << 40)));
+  inner.set_field(2, make_binary(std::string("a\0b", 3)));
+
+  ThriftValue real;
+  real.type = ThriftType::kDouble;
+  real.real = -2.5;
+
+  ThriftValue long_list = make_list(ThriftType::kI32);
+  for (int i = 0; i < 20; ++i) {
+    long_list.elements.push_back(
+        ThriftValue::Integer(ThriftType::kI32, i * 1000 - 7));
+  }
+  ThriftValue bools = make_list(ThriftType::kBool);
+  for (int flag : {1, 0, 1}) {
+    bools.elements.push_back(ThriftValue::Integer(ThriftType::kBool, flag));
+  }
+  ThriftValue structs = make_list(ThriftType::kStruct);
+  structs.elements.push_back(inner);
+  structs.elements.push_back(make_struct());
+
+  ThriftValue set;
+  set.type = ThriftType::kSet;
+  set.element_type = ThriftType::kI64;
+  set.elements = {ThriftValue::Integer(ThriftType::kI64, 0),
+                  ThriftValue::Integer(ThriftType::kI64, INT64_MIN)};
+
+  ThriftValue map;
+  map.type = ThriftType::kMap;
+  map.element_type = ThriftType::kBinary;
+  map.value_type = ThriftType::kI16;
+  map.elements = {make_binary("key"),
+                  ThriftValue::Integer(ThriftType::kI16, -300)};
+
+  ThriftValue value = make_struct();
+  value.set_field(1, ThriftValue::Integer(ThriftType::kBool, 1));
+  value.set_field(2, ThriftValue::Integer(ThriftType::kBool, 0));
+  value.set_field(3, ThriftValue::Integer(ThriftType::kByte, -5));
+  value.set_field(4, ThriftValue::Integer(ThriftType::kI16, -32768));
+  value.set_field(5, ThriftValue::Integer(ThriftType::kI32, 2147483647));
+  value.set_field(7, real);
+  value.set_field(8, inner);
+  value.set_field(9, long_list);
+  value.set_field(10, bools);
+  value.set_field(11, structs);
+  value.set_field(12, map);
+  value.set_field(13, set);
+  // Delta over 15: the id follows the type byte as a zigzag varint
+  value.set_field(100, make_binary("far"));
+  return value;
+}
+
+int main() {
+  // Byte-exact encodings from the compact protocol spec
+  {
+    ThriftValue value = make_struct();
+    value.set_field(1, ThriftValue::Integer(ThriftType::kI32, 150));
+    CHECK(encode(value) == std::string("\x15\xac\x02\x00", 4));
+
+    ThriftValue flags = make_struct();
+    flags.set_field(1, ThriftValue::Integer(ThriftType::kBool, 1));
+    flags.set_field(2, ThriftValue::Integer(ThriftType::kBool, 0));
+    CHECK(encode(flags) == std::string("\x11\x12\x00", 3));
+
+    ThriftValue far = make_struct();
+    far.set_field(100, make_binary("abc"));
+    CHECK(encode(far) == std::string("\x08\xc8\x01\x03" "abc" "\x00", 8));
+  }
+
+  // Round trip: decoding and re-encoding reproduces the bytes
+  const std::string bytes = encode(sample_struct());
+  ThriftValue decoded = decode(bytes);
+  CHECK(encode(decoded) == bytes);
+  CHECK(decoded.fields.size() == 13);
+  CHECK(decoded.field(1) && decoded.field(1)->integer == 1);
+  CHECK(decoded.field(2) && decoded.field(2)->integer == 0);
+  CHECK(decoded.field(3) && decoded.field(3)->integer == -5);
+  CHECK(decoded.field(4) && decoded.field(4)->integer == -32768);
+  CHECK(decoded.field(5) && decoded.field(5)->integer == 2147483647);
+  CHECK(decoded.field(7) && decoded.field(7)->real == -2.5);
+  const ThriftValue *inner = decoded.field(8);
+  CHECK(inner && inner->field(1) &&
+        inner->field(1)->integer == -(int64_t{1} << 40));
+  CHECK(inner && inner->field(2) &&
+        inner->field(2)->binary == std::string("a\0b", 3));
+  const ThriftValue *long_list = decoded.field(9);
+  CHECK(long_list && long_list->elements.size() == 20 &&
+        long_list->elements[19].integer == 18993);
+  const ThriftValue *bools = decoded.field(10);
+  CHECK(bools && bools->elements.size() == 3 &&
+        bools->elements[0].integer == 1 && bools->elements[1].integer == 0);
+  const ThriftValue *structs = decoded.field(11);
+  CHECK(structs && structs->elements.size() == 2 &&
+        structs->elements[1].fields.empty());
+  const ThriftValue *map = decoded.field(12);
+  CHECK(map && map->elements.size() == 2 &&
+        map->elements[0].binary == "key" && map->elements[1].integer == -300);
+  const ThriftValue *set = decoded.field(13);
+  CHECK(set && set->type == ThriftType::kSet && set->elements.size() == 2 &&
+        set->elements[1].integer == INT64_MIN);
+  CHECK(decoded.field(100) && decoded.field(100)->binary == "far");
+  CHECK(decoded.field(6) == nullptr);
+
+  // Editing by id keeps the fields in id order
+  decoded.set_field(6, ThriftValue::Integer(ThriftType::kI32, 6));
+  decoded.remove_field(100);
+  ThriftValue edited = decode(encode(decoded));
+  CHECK(edited.fields.size() == 13);
+  CHECK(edited.fields[5].id == 6 && edited.fields[5].value.integer == 6);
+  CHECK(edited.field(100) == nullptr);
+
+  // Every truncation of the input is rejected rather than misread
+  for (size_t length = 0; length < bytes.size(); ++length) {
+    bool threw = false;
+    try {
+      ThriftCompactReader reader(
+          reinterpret_cast<const uint8_t *>(bytes.data()), length);
+      reader.read_struct();
+    } catch (const std::runtime_error &) {
+      threw = true;
+    }
+    if (!threw) {
+      std::fprintf(stderr, "truncation to %zu bytes was accepted\n", length);
+      ++failures;
+    }
+  }
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("thrift_compact_test: OK\n");
+  return 0;
+}
@@ -0,0 +1,127 @@
+// training_sample_encoder_test.cpp
+#include "training_sample_encoder.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "game_record.h"
+
+using Encoder = TrainingSampleEncoder;
+
+static int failures = 0;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__,    \
+                   #cond);                                                     \
+      ++failures;                                                              \
+    }                                                                          \
+  } while (0)
+
+struct Sample {
+  int turn;
+  float value;
+  int move;
+  std::vector<float> state;
+  std::vector<int> mask;
+};
+
+// Expected rows, copied from the old trainer's output (old_trainer/main.cpp,
+// random seed 7) for the game replayed below
+static const Sample kOldPlayerRow = {
+    1,
+    -1.0f,
+    367,
+    {1.0f,  0.0f,  0.25f, 0.25f, 0.25f, 0.25f,      0.5f, 0.5f, 0.25f,
+     0.5f,  0.75f, 0.25f, 1 / 3.0f, 0.0f, 0.0f,     0.0f, 0.0f, 0.0f,
+     0.0f,  1.0f,  0.0f,  0.0f,  2 / 3.0f, 0.75f,   0.0f, 0.375f},
+    {0, 367, 368}};
+static const Sample kOldOpponentRow = {
+    0,
+    1.0f,
+    367,
+    {0.0f, 0.5f, 0.0f, 0.0f, 0.0f,     0.0f, 0.0f,     0.0f,  0.0f,
+     0.0f, 0.0f, 0.5f, 2 / 3.0f, 0.0f, 0.0f, 0.0f,     0.0f,  0.0f,
+     0.0f, 1.0f, 0.0f, 0.0f,     2 / 3.0f, 0.75f, 0.0f, 1.0f},
+    {0, 286, 287, 288, 289, 290, 291, 292, 293, 294, 295, 296, 297, 366, 367,
+     368}};
+
+static Sample encode(const GameRecord &record, const TurnRecord &turn,
+                     int head) {
+  Sample sample;
+  sample.turn = head;
+  sample.value = Encoder::encode_value(record, turn, head);
+  sample.move = Encoder::encode_move(turn);
+  sample.state.resize(Encoder::kStateSize);
+  Encoder::encode_state(turn, head, sample.state.data());
+  std::vector<uint8_t> mask(Encoder::kMaskSize);
+  Encoder::encode_legal_mask(turn, head, mask.data());
+  for (int id = 0; id < Encoder::kMaskSize; ++id) {
+    if (mask[id]) {
+      sample.mask.push_back(id);
+    }
+  }
+  return sample;
+}
+
+static void check_row(const Sample &actual, const Sample &expected) {
+  CHECK(actual.turn == expected.turn);
+  CHECK(actual.value == expected.value);
+  CHECK(actual.move == expected.move);
+  for (int i = 0; i < Encoder::kStateSize; ++i) {
+    // The old trainer printed its floats with six significant digits
+    if (std::fabs(actual.state[i] - expected.state[i]) > 1e-5f) {
+      std::fprintf(stderr, "state[%d]: %g, expected %g\n", i, actual.state[i],
+                   expected.state[i]);
+      ++failures;
+    }
+  }
+  CHECK(actual.mask == expected.mask);
+}
+
+int main() {
+  CHECK(Encoder::kStateSize == 26);
+  CHECK(Encoder::kMaskSize == 467);
+
+  // A bomb-free game from the old trainer's run, replayed move by move
+  Game game;
+  game.deal({{{0, 1, 1, 1, 1, 2, 2, 1, 2, 3, 1, 1, 0},
+              {3, 1, 1, 1, 1, 1, 1, 1, 1, 0, 2, 2, 1}}},
+            1);
+  GameRecord record(Encoder::kFields);
+  record.set_initial_state(game);
+  for (int id : {365, 367, 0, 23, 24, 0, 14, 0, 25}) {
+    record.add_move(Move(id));
+  }
+  CHECK(record.game().is_over());
+
+  std::vector<Sample> samples;
+  for (const auto &turn : record.turns()) {
+    if (Encoder::has_player_sample(turn)) {
+      samples.push_back(encode(record, turn, Encoder::kPlayerHead));
+    }
+    if (Encoder::has_opponent_sample(turn)) {
+      samples.push_back(encode(record, turn, Encoder::kOpponentHead));
+    }
+  }
+
+  // The old trainer emitted 11 samples for this game, in this head order
+  const std::vector<int> old_heads = {1, 1, 0, 1, 0, 1, 0, 1, 0, 0, 0};
+  CHECK(samples.size() == old_heads.size());
+  if (samples.size() == old_heads.size()) {
+    for (size_t i = 0; i < samples.size(); ++i) {
+      CHECK(samples[i].turn == old_heads[i]);
+    }
+    check_row(samples[1], kOldPlayerRow);
+    check_row(samples[2], kOldOpponentRow);
+  }
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("training_sample_encoder_test: OK\n");
+  return 0;
+}
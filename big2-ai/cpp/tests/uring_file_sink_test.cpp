@@ -0,0 +1,145 @@
+// uring_file_sink_test.cpp
+#include "uring_file_sink.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__,    \
+                   #cond);                                                     \
+      ++failures;                                                              \
+    }                                                                          \
+  } while (0)
+
+// Small buffers and a shallow queue so a few KB cycle through every slot
+constexpr size_t kBufferSize = 4096;
+constexpr unsigned kQueueDepth = 2;
+
+template <typename F> static bool throws(F &&f) {
+  try {
+    f();
+  } catch (const std::exception &) {
+    return true;
+  }
+  return false;
+}
+
+static std::vector<char> pattern(size_t size) {
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<char>(i * 31 + i / 251);
+  }
+  return data;
+}
+
+static std::vector<char> read_file(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(in),
+                           std::istreambuf_iterator<char>());
+}
+
+// Unaligned chunks straddling buffer boundaries land in order
+static void check_round_trip(const std::string &path, bool allow_io_uring) {
+  const std::vector<char> data = pattern(10 * kBufferSize + 123);
+  {
+    UringFileSink sink(path, kBufferSize, kQueueDepth, allow_io_uring);
+    CHECK(allow_io_uring || !sink.uses_io_uring());
+    size_t offset = 0;
+    for (size_t chunk = 1; offset < data.size(); chunk = chunk * 3 + 7) {
+      const size_t n = std::min(chunk, data.size() - offset);
+      sink.write(data.data() + offset, n);
+      offset += n;
+    }
+    CHECK(sink.tell() == static_cast<int64_t>(data.size()));
+    sink.close();
+    CHECK(sink.closed());
+  }
+  CHECK(read_file(path) == data);
+}
+
+// A failed write is reported by every later call, not just the next one
+static void check_failed_write(bool allow_io_uring) {
+  UringFileSink sink("/dev/full", kBufferSize, kQueueDepth, allow_io_uring);
+  const std::vector<char> data = pattern(3 * kBufferSize);
+  // The failure surfaces once a completion is reaped: during this write
+  // when it has to wait for a free buffer, otherwise in flush()
+  (void)throws([&] { sink.write(data.data(), data.size()); });
+  CHECK(throws([&] { sink.flush(); }));
+  CHECK(throws([&] { sink.write(data.data(), 1); }));
+  CHECK(throws([&] { sink.tell(); }));
+  CHECK(throws([&] { sink.close(); }));
+  CHECK(sink.closed());
+  CHECK(throws([&] { sink.close(); }));
+}
+
+// RLIMIT_FSIZE cuts the last buffer short. The sink must keep the bytes
+// that were written, resubmit the remainder and then report its failure
+static void check_short_write(const std::string &path, bool allow_io_uring) {
+  constexpr rlim_t kLimit = 2 * kBufferSize + 1808;
+  const std::vector<char> data = pattern(3 * kBufferSize);
+
+  rlimit saved;
+  getrlimit(RLIMIT_FSIZE, &saved);
+  rlimit limit = saved;
+  limit.rlim_cur = kLimit;
+  CHECK(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+  bool failed = false;
+  {
+    UringFileSink sink(path, kBufferSize, kQueueDepth, allow_io_uring);
+    failed = throws([&] {
+      sink.write(data.data(), data.size());
+      sink.close();
+    });
+    failed = throws([&] { sink.close(); }) && failed;
+  }
+  setrlimit(RLIMIT_FSIZE, &saved);
+
+  CHECK(failed);
+  const std::vector<char> written = read_file(path);
+  CHECK(written.size() == kLimit);
+  CHECK(std::equal(written.begin(), written.end(), data.begin()));
+}
+
+int main() {
+  // Past the size limit write() must fail with EFBIG, not kill the process
+  std::signal(SIGXFSZ, SIG_IGN);
+
+  char dir_template[] = "/tmp/uring_file_sink_test.XXXXXX";
+  const char *dir = mkdtemp(dir_template);
+  if (dir == nullptr) {
+    std::perror("mkdtemp");
+    return 1;
+  }
+  const std::string path = std::string(dir) + "/out.bin";
+
+  // The default sink where the kernel allows io_uring, then the fallback
+  for (bool allow_io_uring : {true, false}) {
+    check_round_trip(path, allow_io_uring);
+    check_failed_write(allow_io_uring);
+    check_short_write(path, allow_io_uring);
+  }
+
+  unlink(path.c_str());
+  rmdir(dir);
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("uring_file_sink_test: OK\n");
+  return 0;
+}
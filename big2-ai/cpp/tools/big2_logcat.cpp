@@ -0,0 +1,125 @@
+// big2_logcat.cpp
+//
+// big2-logcat: render binary event logs written by GameCoordinator as text.
+//
+//   big2-logcat [-g <game id>] logs_thread0.b2log [logs_thread1.b2log ...]
+#include "event_log.h"
+#include "move.h"
+#include "util.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static std::string hand_text(uint64_t packed) {
+  std::string out;
+  for (int r = 0; r < 13; ++r) {
+    int count = (packed >> (4 * r)) & 0xf;
+    out.append(count, rankToChar(r + 3));
+  }
+  return out;
+}
+
+static void print_event(const LogEvent &e) {
+  std::ostringstream line;
+  line << "game " << e.game_id << ' ';
+  switch (e.kind) {
+  case LogEvent::kDeal:
+    line << "deal    P" << int(e.player) << " [" << hand_text(e.payload)
+         << "]";
+    break;
+  case LogEvent::kMove: {
+    line << "turn " << e.turn << "  P" << int(e.player) << ' '
+         << Move(static_cast<int>(e.move)) << "  hands " << int(e.hand_sizes[0])
+         << '/' << int(e.hand_sizes[1]);
+    char hash[20];
+    std::snprintf(hash, sizeof(hash), "%016llx",
+                  static_cast<unsigned long long>(e.payload));
+    line << "  state " << hash;
+    break;
+  }
+  case LogEvent::kEnd:
+    line << "end     winner P" << int(e.player) << " after " << e.payload
+         << " turns";
+    break;
+  default:
+    line << "unknown event kind " << int(e.kind);
+  }
+  std::cout << line.str() << '\n';
+}
+
+static bool cat_file(const char *path, bool filter, uint64_t game_id) {
+  FILE *file = std::fopen(path, "rb");
+  if (!file) {
+    std::cerr << "big2-logcat: cannot open " << path << "\n";
+    return false;
+  }
+  LogFileHeader header;
+  if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+      std::memcmp(header.magic, kLogMagic, sizeof(kLogMagic)) != 0 ||
+      header.event_size != sizeof(LogEvent)) {
+    std::cerr << "big2-logcat: " << path << " is not a b2log v1 file\n";
+    std::fclose(file);
+    return false;
+  }
+  LogEvent events[4096];
+  size_t n;
+  while ((n = std::fread(events, sizeof(LogEvent), 4096, file)) > 0) {
+    for (size_t i = 0; i < n; ++i) {
+      if (!filter || events[i].game_id == game_id)
+        print_event(events[i]);
+    }
+  }
+  std::fclose(file);
+  return true;
+}
+
+static void usage() {
+  std::cerr << "Usage: big2-logcat [-g <game id>] <file.b2log>...\n";
+}
+
+// Parses a whole decimal game id; false on anything else
+static bool parse_game_id(const char *text, uint64_t &game_id) {
+  if (!std::isdigit(static_cast<unsigned char>(text[0]))) {
+    return false;
+  }
+  char *end = nullptr;
+  errno = 0;
+  const unsigned long long value = std::strtoull(text, &end, 10);
+  if (errno != 0 || *end != '\0') {
+    return false;
+  }
+  game_id = value;
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  bool filter = false;
+  uint64_t game_id = 0;
+  int status = 0;
+  int files = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "-g") == 0) {
+      if (i + 1 >= argc || !parse_game_id(argv[i + 1], game_id)) {
+        std::cerr << "big2-logcat: -g needs a game id\n";
+        usage();
+        return 2;
+      }
+      filter = true;
+      ++i;
+    } else {
+      status |= !cat_file(argv[i], filter, game_id);
+      ++files;
+    }
+  }
+  if (files == 0) {
+    usage();
+    return 2;
+  }
+  return status;
+}
@@ -0,0 +1,69 @@
+// big2_merge.cpp
+//
+// big2-merge: concatenate Parquet feature files from many runs or shards
+// into one file by copying their row groups byte for byte.
+//
+//   big2-merge -o merged.parquet shard-00000.parquet shard-00001.parquet ...
+#include "parquet_merge.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+static void usage() {
+  std::cerr << "Usage: big2-merge -o <output.parquet> <input.parquet>...\n";
+}
+
+int main(int argc, char *argv[]) {
+  std::string output;
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      output = argv[++i];
+    } else {
+      inputs.push_back(argv[i]);
+    }
+  }
+  if (output.empty() || inputs.empty()) {
+    usage();
+    return 1;
+  }
+
+  // The output replaces whatever is at its path, so it must not be one of
+  // the files being read
+  struct stat out_st;
+  if (::stat(output.c_str(), &out_st) == 0) {
+    for (const auto &input : inputs) {
+      struct stat in_st;
+      if (::stat(input.c_str(), &in_st) == 0 &&
+          in_st.st_dev == out_st.st_dev && in_st.st_ino == out_st.st_ino) {
+        std::cerr << "big2-merge: output '" << output
+                  << "' is also an input." << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  try {
+    ParquetMerger merger(output);
+    for (const auto &input : inputs) {
+      merger.add(input);
+    }
+    auto stats = merger.finish();
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    std::cout << "Merged " << stats.files << " files (" << stats.row_groups
+              << " row groups, " << stats.rows << " rows) into " << output
+              << ": " << stats.bytes / 1e6 << " MB in " << seconds << " s\n";
+  } catch (const std::exception &e) {
+    std::cerr << "big2-merge: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
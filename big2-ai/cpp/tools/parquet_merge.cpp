@@ -0,0 +1,310 @@
+// parquet_merge.cpp
+#include "parquet_merge.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Field ids from parquet.thrift
+namespace {
+enum FileMetaDataField : int16_t {
+  kSchema = 2,
+  kNumRows = 3,
+  kRowGroups = 4,
+  kEncryptionAlgorithm = 8,
+};
+enum RowGroupField : int16_t {
+  kColumns = 1,
+  kRowGroupNumRows = 3,
+  kRowGroupFileOffset = 5,
+  kOrdinal = 7,
+};
+enum ColumnChunkField : int16_t {
+  kFilePath = 1,
+  kChunkFileOffset = 2,
+  kMetaData = 3,
+  kOffsetIndexOffset = 4,
+  kOffsetIndexLength = 5,
+  kColumnIndexOffset = 6,
+  kColumnIndexLength = 7,
+  kCryptoMetadata = 8,
+  kEncryptedColumnMetadata = 9,
+};
+enum ColumnMetaDataField : int16_t {
+  kDataPageOffset = 9,
+  kIndexPageOffset = 10,
+  kDictionaryPageOffset = 11,
+  kBloomFilterOffset = 14,
+};
+} // namespace
+
+static constexpr char kMagic[] = "PAR1";
+static constexpr int64_t kMagicSize = 4;
+
+static std::runtime_error io_error(const std::string &what,
+                                   const std::string &path) {
+  return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+}
+
+static void read_exact(int fd, void *out, size_t length, int64_t offset,
+                       const std::string &path) {
+  char *dest = static_cast<char *>(out);
+  while (length > 0) {
+    ssize_t n = ::pread(fd, dest, length, offset);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      throw io_error("cannot read", path);
+    dest += n;
+    offset += n;
+    length -= static_cast<size_t>(n);
+  }
+}
+
+// Makes a rename in the directory of `path` durable
+static void sync_parent_directory(const std::string &path) {
+  const size_t slash = path.rfind('/');
+  const std::string dir = slash == std::string::npos ? "."
+                          : slash == 0                ? "/"
+                                                      : path.substr(0, slash);
+  int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd < 0) {
+    throw io_error("cannot open", dir);
+  }
+  if (::fsync(fd) != 0) {
+    const int error = errno;
+    ::close(fd);
+    errno = error;
+    throw io_error("cannot sync", dir);
+  }
+  ::close(fd);
+}
+
+static void shift(ThriftValue *value, int64_t delta) {
+  if (value) {
+    value->integer += delta;
+  }
+}
+
+ParquetMerger::ParquetMerger(const std::string &output_path)
+    : _output_path(output_path), _temp_path(output_path + ".XXXXXX") {
+  // Same directory as the output so the final rename stays on one
+  // filesystem
+  _fd = ::mkstemp(&_temp_path[0]);
+  if (_fd < 0) {
+    throw io_error("cannot create", _temp_path);
+  }
+  try {
+    if (::fchmod(_fd, 0644) != 0) {
+      throw io_error("cannot chmod", _temp_path);
+    }
+    write_bytes(kMagic, kMagicSize);
+  } catch (...) {
+    ::close(_fd);
+    ::unlink(_temp_path.c_str());
+    throw;
+  }
+}
+
+ParquetMerger::~ParquetMerger() {
+  if (_fd >= 0) {
+    ::close(_fd);
+  }
+  if (!_committed) {
+    ::unlink(_temp_path.c_str());
+  }
+}
+
+void ParquetMerger::write_bytes(const char *data, size_t length) {
+  size_t done = 0;
+  while (done < length) {
+    ssize_t n = ::write(_fd, data + done, length - done);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      throw io_error("cannot write", _output_path);
+    done += static_cast<size_t>(n);
+  }
+  _offset += static_cast<int64_t>(length);
+}
+
+void ParquetMerger::copy_range(int in_fd, int64_t begin, int64_t length,
+                               const std::string &input_path) {
+  // Let the kernel move the bytes; fall back to a user-space copy on
+  // filesystems that do not support copy_file_range
+  loff_t in_offset = begin;
+  int64_t remaining = length;
+  while (remaining > 0) {
+    ssize_t n = ::copy_file_range(in_fd, &in_offset, _fd, nullptr,
+                                  static_cast<size_t>(remaining), 0);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      break;
+    remaining -= n;
+    _offset += n;
+  }
+
+  std::vector<char> buffer(1 << 20);
+  while (remaining > 0) {
+    size_t chunk = std::min<int64_t>(remaining, buffer.size());
+    read_exact(in_fd, buffer.data(), chunk, in_offset, input_path);
+    write_bytes(buffer.data(), chunk);
+    in_offset += static_cast<loff_t>(chunk);
+    remaining -= static_cast<int64_t>(chunk);
+  }
+}
+
+void ParquetMerger::add(const std::string &input_path) {
+  int fd = ::open(input_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw io_error("cannot open", input_path);
+  }
+  struct FdCloser {
+    int fd;
+    ~FdCloser() { ::close(fd); }
+  } closer{fd};
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    throw io_error("cannot stat", input_path);
+  }
+  const int64_t file_size = st.st_size;
+  if (file_size < 2 * kMagicSize + 4) {
+    throw std::runtime_error("'" + input_path + "' is not a Parquet file.");
+  }
+
+  // Trailer: 4-byte little-endian footer length, then the magic
+  unsigned char trailer[8];
+  read_exact(fd, trailer, sizeof(trailer), file_size - 8, input_path);
+  if (std::memcmp(trailer + 4, kMagic, kMagicSize) != 0) {
+    throw std::runtime_error("'" + input_path +
+                             "' is not a plaintext Parquet file.");
+  }
+  const int64_t footer_length = trailer[0] | (trailer[1] << 8) |
+                                (trailer[2] << 16) |
+                                (int64_t{trailer[3]} << 24);
+  const int64_t footer_start = file_size - 8 - footer_length;
+  if (footer_start < kMagicSize) {
+    throw std::runtime_error("'" + input_path + "': bad footer length.");
+  }
+
+  std::vector<uint8_t> footer(footer_length);
+  read_exact(fd, footer.data(), footer.size(), footer_start, input_path);
+  ThriftCompactReader reader(footer.data(), footer.size());
+  ThriftValue metadata = reader.read_struct();
+
+  if (metadata.field(kEncryptionAlgorithm)) {
+    throw std::runtime_error("'" + input_path + "' is encrypted.");
+  }
+  const ThriftValue *schema = metadata.field(kSchema);
+  const ThriftValue *row_groups = metadata.field(kRowGroups);
+  if (!schema || !row_groups) {
+    throw std::runtime_error("'" + input_path + "': footer has no schema.");
+  }
+  // Schemas are compared by their serialized form
+  ThriftValue schema_only;
+  schema_only.type = ThriftType::kStruct;
+  schema_only.set_field(kSchema, *schema);
+  ThriftCompactWriter schema_writer;
+  schema_writer.write_struct(schema_only);
+
+  if (_stats.files == 0) {
+    _schema_bytes = schema_writer.buffer();
+    _metadata = metadata;
+    _metadata.field(kRowGroups)->elements.clear();
+  } else if (schema_writer.buffer() != _schema_bytes) {
+    throw std::runtime_error("'" + input_path +
+                             "' has a different schema than the first input.");
+  }
+
+  // Everything between the leading magic and the footer moves as one block,
+  // so every absolute offset inside it shifts by the same amount
+  const int64_t delta = _offset - kMagicSize;
+  ThriftValue &merged_groups = *_metadata.field(kRowGroups);
+  for (ThriftValue group : row_groups->elements) {
+    ThriftValue *columns = group.field(kColumns);
+    if (!columns) {
+      throw std::runtime_error("'" + input_path +
+                               "': row group has no columns.");
+    }
+    for (ThriftValue &chunk : columns->elements) {
+      if (chunk.field(kFilePath) || chunk.field(kCryptoMetadata) ||
+          chunk.field(kEncryptedColumnMetadata)) {
+        throw std::runtime_error("'" + input_path +
+                                 "': external or encrypted column chunks "
+                                 "are not supported.");
+      }
+      ThriftValue *file_offset = chunk.field(kChunkFileOffset);
+      if (file_offset && file_offset->integer > 0) {
+        file_offset->integer += delta;
+      }
+      if (ThriftValue *meta = chunk.field(kMetaData)) {
+        shift(meta->field(kDataPageOffset), delta);
+        shift(meta->field(kIndexPageOffset), delta);
+        shift(meta->field(kDictionaryPageOffset), delta);
+        shift(meta->field(kBloomFilterOffset), delta);
+      }
+      chunk.remove_field(kOffsetIndexOffset);
+      chunk.remove_field(kOffsetIndexLength);
+      chunk.remove_field(kColumnIndexOffset);
+      chunk.remove_field(kColumnIndexLength);
+    }
+    shift(group.field(kRowGroupFileOffset), delta);
+    // The ordinal is an i16 that only encrypted files need; renumbering it
+    // would overflow past 32767 merged row groups
+    group.remove_field(kOrdinal);
+    if (const ThriftValue *rows = group.field(kRowGroupNumRows)) {
+      _stats.rows += rows->integer;
+    }
+    merged_groups.elements.push_back(std::move(group));
+  }
+
+  copy_range(fd, kMagicSize, footer_start - kMagicSize, input_path);
+  _stats.row_groups += row_groups->elements.size();
+  ++_stats.files;
+}
+
+ParquetMerger::Stats ParquetMerger::finish() {
+  if (_stats.files == 0) {
+    throw std::runtime_error("No input files to merge.");
+  }
+  _metadata.set_field(kNumRows,
+                      ThriftValue::Integer(ThriftType::kI64, _stats.rows));
+  ThriftCompactWriter writer;
+  writer.write_struct(_metadata);
+  const std::string &footer = writer.buffer();
+
+  std::string trailer(4, '\0');
+  for (int i = 0; i < 4; ++i) {
+    trailer[i] = static_cast<char>((footer.size() >> (8 * i)) & 0xff);
+  }
+  write_bytes(footer.data(), footer.size());
+  write_bytes(trailer.data(), trailer.size());
+  write_bytes(kMagic, kMagicSize);
+
+  // Durable before it replaces anything at the output path
+  if (::fsync(_fd) != 0) {
+    throw io_error("cannot sync", _temp_path);
+  }
+  if (::close(_fd) != 0) {
+    _fd = -1;
+    throw io_error("cannot close", _temp_path);
+  }
+  _fd = -1;
+  if (::rename(_temp_path.c_str(), _output_path.c_str()) != 0) {
+    throw io_error("cannot rename to", _output_path);
+  }
+  _committed = true;
+  sync_parent_directory(_output_path);
+  _stats.bytes = _offset;
+  return _stats;
+}
@@ -0,0 +1,65 @@
+// parquet_merge.h
+#ifndef PARQUET_MERGE_H
+#define PARQUET_MERGE_H
+
+#include <cstdint>
+#include <string>
+
+#include "thrift_compact.h"
+
+/**
+ * @brief Concatenates Parquet files without decoding any data.
+ *
+ * The row-group bytes of every input are copied verbatim (kernel-side where
+ * possible) and a new footer is written whose row groups point at the
+ * copied column chunks. All inputs must have the same schema. Page indexes
+ * are dropped because their page locations are not rewritten; bloom
+ * filters are kept.
+ *
+ * The merged file is built under a temporary name next to the output and
+ * renamed into place by finish(), so a failed merge never leaves a partial
+ * file at the output path.
+ */
+class ParquetMerger {
+public:
+  struct Stats {
+    size_t files = 0;
+    size_t row_groups = 0;
+    int64_t rows = 0;
+    int64_t bytes = 0;
+  };
+
+  explicit ParquetMerger(const std::string &output_path);
+  ~ParquetMerger();
+
+  ParquetMerger(const ParquetMerger &) = delete;
+  ParquetMerger &operator=(const ParquetMerger &) = delete;
+
+  /**
+   * @brief Append every row group of `input_path`.
+   */
+  void add(const std::string &input_path);
+
+  /**
+   * @brief Write the merged footer and rename the output into place.
+   */
+  Stats finish();
+
+private:
+  std::string _output_path;
+  std::string _temp_path;
+  int _fd = -1;
+  bool _committed = false;
+  int64_t _offset = 0;
+  Stats _stats;
+
+  // Footer of the first input with its row groups replaced as we go
+  ThriftValue _metadata;
+  std::string _schema_bytes;
+
+  void write_bytes(const char *data, size_t length);
+  void copy_range(int in_fd, int64_t begin, int64_t length,
+                  const std::string &input_path);
+};
+
+#endif // PARQUET_MERGE_H
@@ -0,0 +1,283 @@
+// thrift_compact.cpp
+#include "thrift_compact.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+// Nesting limit; Parquet footers are only a few levels deep
+static constexpr int kMaxDepth = 64;
+
+ThriftValue ThriftValue::Integer(ThriftType type, int64_t value) {
+  ThriftValue v;
+  v.type = type;
+  v.integer = value;
+  return v;
+}
+
+ThriftValue *ThriftValue::field(int16_t id) {
+  for (auto &f : fields) {
+    if (f.id == id)
+      return &f.value;
+  }
+  return nullptr;
+}
+
+const ThriftValue *ThriftValue::field(int16_t id) const {
+  return const_cast<ThriftValue *>(this)->field(id);
+}
+
+void ThriftValue::set_field(int16_t id, ThriftValue value) {
+  if (ThriftValue *existing = field(id)) {
+    *existing = std::move(value);
+    return;
+  }
+  auto pos = std::find_if(fields.begin(), fields.end(),
+                          [&](const ThriftField &f) { return f.id > id; });
+  fields.insert(pos, ThriftField{id, std::move(value)});
+}
+
+void ThriftValue::remove_field(int16_t id) {
+  fields.erase(std::remove_if(fields.begin(), fields.end(),
+                              [&](const ThriftField &f) { return f.id == id; }),
+               fields.end());
+}
+
+// ---------------------------------------------------------------- reading
+
+uint8_t ThriftCompactReader::read_byte() {
+  if (_pos >= _size) {
+    throw std::runtime_error("Thrift: unexpected end of data.");
+  }
+  return _data[_pos++];
+}
+
+uint64_t ThriftCompactReader::read_varint() {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t byte = read_byte();
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return result;
+    }
+  }
+  throw std::runtime_error("Thrift: varint too long.");
+}
+
+int64_t ThriftCompactReader::read_zigzag() {
+  uint64_t n = read_varint();
+  return static_cast<int64_t>(n >> 1) ^ -static_cast<int64_t>(n & 1);
+}
+
+// Compact element types use 2 (BOOLEAN_FALSE) and 1 interchangeably for bool
+static ThriftType element_type(uint8_t nibble) {
+  if (nibble == 2) {
+    return ThriftType::kBool;
+  }
+  if (nibble == 0 || nibble > static_cast<uint8_t>(ThriftType::kStruct)) {
+    throw std::runtime_error("Thrift: unknown element type.");
+  }
+  return static_cast<ThriftType>(nibble);
+}
+
+ThriftValue ThriftCompactReader::read_struct() {
+  if (++_depth > kMaxDepth) {
+    throw std::runtime_error("Thrift: nesting too deep.");
+  }
+  ThriftValue value;
+  value.type = ThriftType::kStruct;
+  int16_t last_id = 0;
+  while (true) {
+    uint8_t header = read_byte();
+    if (header == 0) {
+      break;
+    }
+    uint8_t type = header & 0x0f;
+    uint8_t delta = header >> 4;
+    int16_t id = delta ? static_cast<int16_t>(last_id + delta)
+                       : static_cast<int16_t>(read_zigzag());
+    last_id = id;
+
+    ThriftValue field;
+    if (type == 1 || type == 2) {
+      // Field booleans carry their value in the type nibble
+      field = ThriftValue::Integer(ThriftType::kBool, type == 1);
+    } else {
+      field = read_value(element_type(type));
+    }
+    value.fields.push_back(ThriftField{id, std::move(field)});
+  }
+  --_depth;
+  return value;
+}
+
+ThriftValue ThriftCompactReader::read_value(ThriftType type) {
+  ThriftValue value;
+  value.type = type;
+  switch (type) {
+  case ThriftType::kBool:
+    value.integer = read_byte() == 1;
+    break;
+  case ThriftType::kByte:
+    value.integer = static_cast<int8_t>(read_byte());
+    break;
+  case ThriftType::kI16:
+  case ThriftType::kI32:
+  case ThriftType::kI64:
+    value.integer = read_zigzag();
+    break;
+  case ThriftType::kDouble: {
+    if (_size - _pos < 8) {
+      throw std::runtime_error("Thrift: unexpected end of data.");
+    }
+    std::memcpy(&value.real, _data + _pos, 8);
+    _pos += 8;
+    break;
+  }
+  case ThriftType::kBinary: {
+    uint64_t length = read_varint();
+    if (length > _size - _pos) {
+      throw std::runtime_error("Thrift: binary runs past end of data.");
+    }
+    value.binary.assign(reinterpret_cast<const char *>(_data + _pos), length);
+    _pos += length;
+    break;
+  }
+  case ThriftType::kList:
+  case ThriftType::kSet: {
+    uint8_t header = read_byte();
+    uint64_t count = header >> 4;
+    if (count == 15) {
+      count = read_varint();
+    }
+    value.element_type = element_type(header & 0x0f);
+    // Every element takes at least one byte
+    if (count > _size - _pos) {
+      throw std::runtime_error("Thrift: list runs past end of data.");
+    }
+    value.elements.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+      value.elements.push_back(read_value(value.element_type));
+    }
+    break;
+  }
+  case ThriftType::kMap: {
+    uint64_t count = read_varint();
+    if (count > _size - _pos) {
+      throw std::runtime_error("Thrift: map runs past end of data.");
+    }
+    if (count > 0) {
+      uint8_t types = read_byte();
+      value.element_type = element_type(types >> 4);
+      value.value_type = element_type(types & 0x0f);
+    }
+    value.elements.reserve(2 * count);
+    for (uint64_t i = 0; i < count; ++i) {
+      value.elements.push_back(read_value(value.element_type));
+      value.elements.push_back(read_value(value.value_type));
+    }
+    break;
+  }
+  case ThriftType::kStruct:
+    return read_struct();
+  case ThriftType::kStop:
+    throw std::runtime_error("Thrift: unexpected stop type.");
+  }
+  return value;
+}
+
+// ---------------------------------------------------------------- writing
+
+void ThriftCompactWriter::write_varint(uint64_t value) {
+  while (value >= 0x80) {
+    _out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  _out.push_back(static_cast<char>(value));
+}
+
+void ThriftCompactWriter::write_zigzag(int64_t value) {
+  write_varint((static_cast<uint64_t>(value) << 1) ^
+               static_cast<uint64_t>(value >> 63));
+}
+
+void ThriftCompactWriter::write_struct(const ThriftValue &value) {
+  int16_t last_id = 0;
+  for (const auto &field : value.fields) {
+    uint8_t type = static_cast<uint8_t>(field.value.type);
+    if (field.value.type == ThriftType::kBool) {
+      type = field.value.integer ? 1 : 2;
+    }
+    int delta = field.id - last_id;
+    if (delta > 0 && delta <= 15) {
+      _out.push_back(static_cast<char>((delta << 4) | type));
+    } else {
+      _out.push_back(static_cast<char>(type));
+      write_zigzag(field.id);
+    }
+    last_id = field.id;
+    if (field.value.type != ThriftType::kBool) {
+      write_value(field.value);
+    }
+  }
+  _out.push_back(0);
+}
+
+void ThriftCompactWriter::write_value(const ThriftValue &value) {
+  switch (value.type) {
+  case ThriftType::kBool:
+    _out.push_back(value.integer ? 1 : 2);
+    break;
+  case ThriftType::kByte:
+    _out.push_back(static_cast<char>(value.integer));
+    break;
+  case ThriftType::kI16:
+  case ThriftType::kI32:
+  case ThriftType::kI64:
+    write_zigzag(value.integer);
+    break;
+  case ThriftType::kDouble: {
+    char bytes[8];
+    std::memcpy(bytes, &value.real, 8);
+    _out.append(bytes, 8);
+    break;
+  }
+  case ThriftType::kBinary:
+    write_varint(value.binary.size());
+    _out += value.binary;
+    break;
+  case ThriftType::kList:
+  case ThriftType::kSet: {
+    const size_t count = value.elements.size();
+    const uint8_t type = static_cast<uint8_t>(value.element_type);
+    if (count < 15) {
+      _out.push_back(static_cast<char>((count << 4) | type));
+    } else {
+      _out.push_back(static_cast<char>(0xf0 | type));
+      write_varint(count);
+    }
+    for (const auto &element : value.elements) {
+      write_value(element);
+    }
+    break;
+  }
+  case ThriftType::kMap: {
+    const size_t count = value.elements.size() / 2;
+    write_varint(count);
+    if (count > 0) {
+      _out.push_back(
+          static_cast<char>((static_cast<uint8_t>(value.element_type) << 4) |
+                            static_cast<uint8_t>(value.value_type)));
+    }
+    for (const auto &element : value.elements) {
+      write_value(element);
+    }
+    break;
+  }
+  case ThriftType::kStruct:
+    write_struct(value);
+    break;
+  case ThriftType::kStop:
+    throw std::logic_error("Thrift: cannot write a stop value.");
+  }
+}
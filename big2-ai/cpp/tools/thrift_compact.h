@@ -0,0 +1,109 @@
+// thrift_compact.h
+#ifndef THRIFT_COMPACT_H
+#define THRIFT_COMPACT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Wire types of the Thrift compact protocol. Booleans are always
+ * tagged kBool here; their value lives in ThriftValue::integer.
+ */
+enum class ThriftType : uint8_t {
+  kStop = 0,
+  kBool = 1,
+  kByte = 3,
+  kI16 = 4,
+  kI32 = 5,
+  kI64 = 6,
+  kDouble = 7,
+  kBinary = 8,
+  kList = 9,
+  kSet = 10,
+  kMap = 11,
+  kStruct = 12,
+};
+
+struct ThriftField;
+
+/**
+ * @brief Schema-less Thrift value: enough to read a struct, edit a few
+ * fields by id and write it back without knowing the IDL.
+ */
+struct ThriftValue {
+  ThriftType type = ThriftType::kStop;
+  // bool, byte, i16, i32 and i64
+  int64_t integer = 0;
+  double real = 0.0;
+  std::string binary;
+  // Element type of lists and sets; key and value types of maps
+  ThriftType element_type = ThriftType::kStop;
+  ThriftType value_type = ThriftType::kStop;
+  // List/set elements; maps store key, value, key, value, ...
+  std::vector<ThriftValue> elements;
+  // Struct fields in wire order
+  std::vector<ThriftField> fields;
+
+  static ThriftValue Integer(ThriftType type, int64_t value);
+
+  /**
+   * @brief Field `id` of a struct, or nullptr if absent.
+   */
+  ThriftValue *field(int16_t id);
+  const ThriftValue *field(int16_t id) const;
+
+  /**
+   * @brief Set field `id` of a struct, inserting it in id order if absent.
+   */
+  void set_field(int16_t id, ThriftValue value);
+  void remove_field(int16_t id);
+};
+
+struct ThriftField {
+  int16_t id;
+  ThriftValue value;
+};
+
+/**
+ * @brief Decodes compact-protocol bytes. Throws std::runtime_error on
+ * truncated or malformed input.
+ */
+class ThriftCompactReader {
+public:
+  ThriftCompactReader(const uint8_t *data, size_t size)
+      : _data(data), _size(size) {}
+
+  ThriftValue read_struct();
+  size_t position() const { return _pos; }
+
+private:
+  const uint8_t *_data;
+  size_t _size;
+  size_t _pos = 0;
+  int _depth = 0;
+
+  uint8_t read_byte();
+  uint64_t read_varint();
+  int64_t read_zigzag();
+  ThriftValue read_value(ThriftType type);
+};
+
+/**
+ * @brief Encodes values with the compact protocol.
+ */
+class ThriftCompactWriter {
+public:
+  void write_struct(const ThriftValue &value);
+  const std::string &buffer() const { return _out; }
+
+private:
+  std::string _out;
+
+  void write_varint(uint64_t value);
+  void write_zigzag(int64_t value);
+  void write_value(const ThriftValue &value);
+};
+
+#endif // THRIFT_COMPACT_H